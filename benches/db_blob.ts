@@ -0,0 +1,99 @@
+import type { DBOptions } from '@/types';
+import os from 'os';
+import fs from 'fs';
+import path from 'path';
+import crypto from 'crypto';
+import b from 'benny';
+import Logger, { LogLevel, StreamHandler } from '@matrixai/logger';
+import DB from '@/DB';
+import { rocksdbP } from '@/native';
+import { suiteCommon } from './utils';
+
+const logger = new Logger('DBBlob Bench', LogLevel.WARN, [
+  new StreamHandler(),
+]);
+
+/**
+ * Keys are overwritten in turn, so compactions have garbage to drop
+ */
+const keyCount = 64;
+
+const configs: Array<[string, DBOptions]> = [
+  ['tables', {}],
+  [
+    'blob files',
+    {
+      enableBlobFiles: true,
+      minBlobSize: 4096,
+      enableBlobGarbageCollection: true,
+    },
+  ],
+];
+
+/**
+ * Bytes written by flushes and compactions per byte written by the user
+ */
+function writeAmplification(db: DB): number {
+  const { tickers } = rocksdbP.dbGetStatistics(db.db)!;
+  return (
+    (tickers['rocksdb.flush.write.bytes'] +
+      tickers['rocksdb.compact.write.bytes']) /
+    tickers['rocksdb.bytes.written']
+  );
+}
+
+async function main() {
+  const dataDir = await fs.promises.mkdtemp(
+    path.join(os.tmpdir(), 'db-benches-'),
+  );
+  const dbs: Array<DB> = [];
+  for (const [i, [, options]] of configs.entries()) {
+    dbs.push(
+      await DB.createDB({
+        dbPath: `${dataDir}/db${i}`,
+        logger,
+        statistics: true,
+        ...options,
+      }),
+    );
+  }
+  const data1MiB = crypto.randomBytes(1024 * 1024);
+  const counters = configs.map(() => 0);
+  const summary = await b.suite(
+    path.basename(__filename, path.extname(__filename)),
+    ...configs.map(([name], i) =>
+      b.add(`overwrite 1 MiB of data, ${name}`, async () => {
+        await dbs[i].put(`${counters[i]++ % keyCount}`, data1MiB, true);
+      }),
+    ),
+    ...suiteCommon,
+  );
+  // Appended to the metrics written by `suiteCommon`
+  await fs.promises.appendFile(
+    path.join(__dirname, 'results', `${summary.name}_metrics.txt`),
+    [
+      '',
+      `# TYPE ${summary.name}_write_amplification gauge`,
+      ...configs.map(
+        ([name], i) =>
+          `${summary.name}_write_amplification{name="${name}"} ` +
+          `${writeAmplification(dbs[i])}`,
+      ),
+      '',
+    ].join('\n'),
+  );
+  for (const db of dbs) {
+    await db.stop();
+  }
+  await fs.promises.rm(dataDir, {
+    force: true,
+    recursive: true,
+  });
+  return summary;
+}
+
+if (require.main === module) {
+  void main();
+}
+
+export default main;
@@ -0,0 +1,68 @@
+import type { DBOptions } from '@/types';
+import os from 'os';
+import fs from 'fs';
+import path from 'path';
+import crypto from 'crypto';
+import b from 'benny';
+import Logger, { LogLevel, StreamHandler } from '@matrixai/logger';
+import DB from '@/DB';
+import { suiteCommon } from './utils';
+
+const logger = new Logger('DBWrite Bench', LogLevel.WARN, [
+  new StreamHandler(),
+]);
+
+/**
+ * Concurrent writers per operation, enough to form write groups
+ */
+const concurrency = 64;
+
+const configs: Array<[string, DBOptions]> = [
+  ['default', {}],
+  ['pipelined', { pipelinedWrite: true }],
+  ['serial memtable', { concurrentMemtableWrite: false }],
+  ['unordered', { unorderedWrite: true }],
+  ['4 write buffers', { maxWriteBufferNumber: 4 }],
+];
+
+async function main() {
+  const dataDir = await fs.promises.mkdtemp(
+    path.join(os.tmpdir(), 'db-benches-'),
+  );
+  const dbs: Array<DB> = [];
+  for (const [i, [, options]] of configs.entries()) {
+    dbs.push(
+      await DB.createDB({ dbPath: `${dataDir}/db${i}`, logger, ...options }),
+    );
+  }
+  const data1KiB = crypto.randomBytes(1024);
+  let counter = 0;
+  const summary = await b.suite(
+    path.basename(__filename, path.extname(__filename)),
+    ...configs.map(([name], i) =>
+      b.add(`put ${concurrency} x 1 KiB concurrently, ${name}`, async () => {
+        const db = dbs[i];
+        const ops: Array<Promise<void>> = [];
+        for (let j = 0; j < concurrency; j++) {
+          ops.push(db.put(`${counter++}`, data1KiB, true));
+        }
+        await Promise.all(ops);
+      }),
+    ),
+    ...suiteCommon,
+  );
+  for (const db of dbs) {
+    await db.stop();
+  }
+  await fs.promises.rm(dataDir, {
+    force: true,
+    recursive: true,
+  });
+  return summary;
+}
+
+if (require.main === module) {
+  void main();
+}
+
+export default main;
@@ -0,0 +1,188 @@
+import type { KeyPath } from '@/types';
+import os from 'os';
+import fs from 'fs';
+import path from 'path';
+import crypto from 'crypto';
+import b from 'benny';
+import Logger, { LogLevel, StreamHandler } from '@matrixai/logger';
+import DB from '@/DB';
+import * as errors from '@/errors';
+import {
+  suiteCommon,
+  ZipfianGenerator,
+  ScrambledZipfianGenerator,
+} from './utils';
+
+const logger = new Logger('DBYCSB Bench', LogLevel.WARN, [
+  new StreamHandler(),
+]);
+
+/**
+ * Records loaded before running the workloads
+ */
+const recordCount = 10000;
+
+/**
+ * A suite is run for each value size
+ */
+const valueSizes = [100, 1024];
+
+/**
+ * Operations in flight at once per benchmark cycle
+ */
+const concurrencies = [1, 16];
+
+/**
+ * Workload E is run with each of these scan lengths
+ */
+const scanLengths = [10, 100];
+
+const levelPath = ['usertable'];
+
+function recordKey(n: number): KeyPath {
+  return [...levelPath, `user${n.toString().padStart(10, '0')}`];
+}
+
+async function runConcurrently(
+  concurrency: number,
+  op: () => Promise<void>,
+): Promise<void> {
+  const ops: Array<Promise<void>> = [];
+  for (let i = 0; i < concurrency; i++) {
+    ops.push(op());
+  }
+  await Promise.all(ops);
+}
+
+async function suite(dataDir: string, valueSize: number) {
+  const db = await DB.createDB({
+    dbPath: `${dataDir}/db_${valueSize}`,
+    logger,
+  });
+  const value = crypto.randomBytes(valueSize);
+  for (let i = 0; i < recordCount; i++) {
+    await db.put(recordKey(i), value, true);
+  }
+  let insertCount = recordCount;
+  const zipfian = new ScrambledZipfianGenerator(recordCount);
+  const latest = new ZipfianGenerator(recordCount);
+  const read = async (n: number) => {
+    await db.get(recordKey(n), true);
+  };
+  const update = async (n: number) => {
+    await db.put(recordKey(n), value, true);
+  };
+  const insert = async () => {
+    await db.put(recordKey(insertCount++), value, true);
+  };
+  const scan = async (n: number, length: number) => {
+    for await (const _ of db.iterator(levelPath, {
+      gte: recordKey(n).slice(levelPath.length),
+      limit: length,
+    })) {
+      // Consume the scan
+    }
+  };
+  // Optimistic commits on hot keys conflict, these are retried and counted
+  let conflictCount = 0;
+  const readModifyWrite = async (n: number) => {
+    while (true) {
+      try {
+        await db.withTransactionF(async (tran) => {
+          await tran.getForUpdate(recordKey(n), true);
+          await tran.put(recordKey(n), value, true);
+        });
+        return;
+      } catch (e) {
+        if (!(e instanceof errors.ErrorDBTransactionConflict)) throw e;
+        conflictCount++;
+      }
+    }
+  };
+  const cases: Array<ReturnType<typeof b.add>> = [];
+  for (const concurrency of concurrencies) {
+    const suffix = `${valueSize} B values, ${concurrency} concurrent`;
+    cases.push(
+      b.add(`workload A, 50% read 50% update, ${suffix}`, async () => {
+        await runConcurrently(concurrency, () =>
+          Math.random() < 0.5 ? read(zipfian.next()) : update(zipfian.next()),
+        );
+      }),
+      b.add(`workload B, 95% read 5% update, ${suffix}`, async () => {
+        await runConcurrently(concurrency, () =>
+          Math.random() < 0.95 ? read(zipfian.next()) : update(zipfian.next()),
+        );
+      }),
+      b.add(`workload C, 100% read, ${suffix}`, async () => {
+        await runConcurrently(concurrency, () => read(zipfian.next()));
+      }),
+      b.add(`workload D, 95% read latest 5% insert, ${suffix}`, async () => {
+        await runConcurrently(concurrency, () =>
+          Math.random() < 0.95
+            ? read(Math.max(insertCount - 1 - latest.next(), 0))
+            : insert(),
+        );
+      }),
+      ...scanLengths.map((scanLength) =>
+        b.add(
+          `workload E, 95% scan of ${scanLength} 5% insert, ${suffix}`,
+          async () => {
+            await runConcurrently(concurrency, () =>
+              Math.random() < 0.95
+                ? scan(zipfian.next(), scanLength)
+                : insert(),
+            );
+          },
+        ),
+      ),
+      b.add(
+        `workload F, 50% read 50% read-modify-write, ${suffix}`,
+        async () => {
+          await runConcurrently(concurrency, () =>
+            Math.random() < 0.5
+              ? read(zipfian.next())
+              : readModifyWrite(zipfian.next()),
+          );
+        },
+      ),
+    );
+  }
+  const summary = await b.suite(
+    `${path.basename(__filename, path.extname(__filename))}_${valueSize}B`,
+    ...cases,
+    ...suiteCommon,
+  );
+  // Appended to the metrics written by `suiteCommon`
+  await fs.promises.appendFile(
+    path.join(__dirname, 'results', `${summary.name}_metrics.txt`),
+    [
+      '',
+      `# TYPE ${summary.name}_transaction_conflicts counter`,
+      `${summary.name}_transaction_conflicts ${conflictCount}`,
+      '',
+    ].join('\n'),
+  );
+  await db.stop();
+  return summary;
+}
+
+async function main() {
+  const dataDir = await fs.promises.mkdtemp(
+    path.join(os.tmpdir(), 'db-benches-'),
+  );
+  const summaries: Array<Awaited<ReturnType<typeof b.suite>>> = [];
+  for (const valueSize of valueSizes) {
+    summaries.push(await suite(dataDir, valueSize));
+  }
+  await fs.promises.rm(dataDir, {
+    force: true,
+    recursive: true,
+  });
+  return summaries;
+}
+
+if (require.main === module) {
+  void main();
+}
+
+export default main;
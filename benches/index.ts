@@ -5,11 +5,17 @@ import path from 'path';
 import si from 'systeminformation';
 import DB1KiB from './db_1KiB';
 import DB1MiB from './db_1MiB';
+import DBBlob from './db_blob';
+import DBWrite from './db_write';
+import DBYCSB from './db_ycsb';
 
 async function main(): Promise<void> {
   await fs.promises.mkdir(path.join(__dirname, 'results'), { recursive: true });
   await DB1KiB();
   await DB1MiB();
+  await DBBlob();
+  await DBWrite();
+  await DBYCSB();
   const resultFilenames = await fs.promises.readdir(
     path.join(__dirname, 'results'),
   );
@@ -0,0 +1,215 @@
+/**
+ * Microbenchmarks of the native hot paths without Node.js
+ * These run against temporary databases opened directly with `Database`,
+ * so only the code that does not touch N-API is measured
+ *
+ * Build with `node-gyp rebuild -- -Dbuild_bench=1` and run
+ * `./build/Release/native_bench`
+ */
+
+#define NAPI_VERSION 3
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <rocksdb/cache.h>
+#include <rocksdb/options.h>
+#include <rocksdb/slice.h>
+#include <rocksdb/status.h>
+#include <rocksdb/write_batch.h>
+
+#include "../../src/native/napi/database.h"
+#include "../../src/native/napi/iterator.h"
+#include "../../src/native/napi/utils.h"
+#include "../../src/native/napi/workers/database_workers.h"
+
+/**
+ * Results are accumulated here so the compiler cannot drop the work
+ */
+static volatile size_t sink = 0;
+
+/**
+ * Runs `f` `rounds` times and prints the time per operation, where each
+ * round performs `ops` operations
+ */
+template <typename F>
+static void Bench(const std::string& name, const uint32_t rounds,
+                  const uint64_t ops, F&& f) {
+  // Warm up caches and allocators
+  f();
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < rounds; i++) f();
+  auto end = std::chrono::steady_clock::now();
+  double ns = std::chrono::duration<double, std::nano>(end - start).count();
+  printf("%-40s %12.2f ns/op %12llu ops\n", name.c_str(),
+         ns / static_cast<double>(rounds * ops),
+         static_cast<unsigned long long>(rounds * ops));
+}
+
+static std::string Key(const uint32_t i) {
+  char key[17];
+  snprintf(key, sizeof(key), "key%013u", i);
+  return std::string(key, 16);
+}
+
+/**
+ * Temporary database filled with `count` entries of `valueSize` bytes
+ */
+struct TempDatabase {
+  TempDatabase(const uint32_t count, const size_t valueSize) {
+    location_ = std::filesystem::temp_directory_path() /
+                ("js-db-bench-" + std::to_string(valueSize));
+    std::filesystem::remove_all(location_);
+    rocksdb::Options options;
+    options.create_if_missing = true;
+    options.create_missing_column_families = true;
+    database_.blockCache_ = rocksdb::NewLRUCache(8 * 1024 * 1024);
+    SetColumnFamilyOptions(options, ColumnFamilyConfig(),
+                           database_.blockCache_);
+    Check(database_.Open(options, location_.c_str(), {}));
+    std::string value(valueSize, 'v');
+    rocksdb::WriteBatch batch;
+    for (uint32_t i = 0; i < count; i++) {
+      batch.Put(database_.defaultColumnFamily_->handle_, Key(i), value);
+    }
+    Check(database_.WriteBatch(rocksdb::WriteOptions(), &batch));
+  }
+
+  ~TempDatabase() {
+    database_.Close();
+    std::filesystem::remove_all(location_);
+  }
+
+  static void Check(const rocksdb::Status& status) {
+    if (status.ok()) return;
+    fprintf(stderr, "%s\n", status.ToString().c_str());
+    exit(1);
+  }
+
+  Iterator* NewIterator(std::string* lt, std::string* gte) {
+    return new Iterator(&database_, database_.defaultColumnFamily_, 0, false,
+                        true, true, -1, lt, nullptr, nullptr, gte, true, false,
+                        false, 16 * 1024, false, false);
+  }
+
+  std::filesystem::path location_;
+  Database database_;
+};
+
+/**
+ * Reads the whole database in batches of `size` like `iteratorNextv`
+ */
+static void BenchReadMany(TempDatabase& db, const uint32_t count,
+                          const size_t valueSize, const bool packed) {
+  std::string name = "Iterator::ReadMany " + std::to_string(valueSize) + "B";
+  if (packed) name += " packed";
+  Bench(name, 20, count, [&db, packed] {
+    Iterator* iterator = db.NewIterator(nullptr, nullptr);
+    iterator->SeekToRange();
+    while (iterator->ReadMany(1000, packed)) {
+      sink = sink + iterator->cache_.size();
+    }
+    iterator->Close();
+    delete iterator;
+  });
+}
+
+static void BenchOutOfRange(TempDatabase& db, const uint32_t count) {
+  std::vector<std::string> keys;
+  keys.reserve(count);
+  for (uint32_t i = 0; i < count; i++) keys.push_back(Key(i));
+  Iterator* iterator =
+      db.NewIterator(new std::string(Key(count * 3 / 4)),
+                     new std::string(Key(count / 4)));
+  Bench("BaseIterator::OutOfRange", 100, count, [iterator, &keys] {
+    size_t outOfRange = 0;
+    for (const std::string& key : keys) {
+      outOfRange += iterator->OutOfRange(key);
+    }
+    sink = sink + outOfRange;
+  });
+  iterator->Close();
+  delete iterator;
+}
+
+static void BenchEntry(const uint32_t count, const size_t valueSize) {
+  std::string key = Key(0);
+  std::string value(valueSize, 'v');
+  rocksdb::Slice keySlice(key);
+  rocksdb::Slice valueSlice(value);
+  std::vector<Entry> entries;
+  entries.reserve(count);
+  Bench("Entry " + std::to_string(valueSize) + "B", 100, count,
+        [&entries, &keySlice, &valueSlice, count] {
+          entries.clear();
+          for (uint32_t i = 0; i < count; i++) {
+            entries.emplace_back(&keySlice, &valueSlice);
+          }
+          sink = sink + entries.size();
+        });
+}
+
+/**
+ * `ToSlice` needs a live `napi_env`, so this measures `CopySlice`, the copy
+ * it makes of every buffer key and value
+ */
+static void BenchCopySlice(const uint32_t count, const size_t size) {
+  std::string from(size, 'k');
+  Bench("CopySlice " + std::to_string(size) + "B", 100, count,
+        [&from, count] {
+          for (uint32_t i = 0; i < count; i++) {
+            rocksdb::Slice slice = CopySlice(from.data(), from.size());
+            sink = sink + static_cast<size_t>(slice.data()[0]);
+            DisposeSliceBuffer(slice);
+          }
+        });
+}
+
+/**
+ * Option setup of `OpenWorker` for the default and `columnFamilies` other
+ * column families
+ */
+static void BenchOpenOptions(const uint32_t columnFamilies,
+                             const uint32_t prefixLevels) {
+  ColumnFamilyConfig config;
+  config.prefixLevels_ = prefixLevels;
+  std::string name = "OpenWorker options " +
+                     std::to_string(columnFamilies) + " column families";
+  if (prefixLevels) name += " with prefixes";
+  Bench(name, 1000, 1, [&config, columnFamilies] {
+    rocksdb::Options options;
+    std::shared_ptr<rocksdb::Cache> blockCache =
+        rocksdb::NewLRUCache(8 * 1024 * 1024);
+    SetColumnFamilyOptions(options, config, blockCache);
+    std::vector<rocksdb::ColumnFamilyDescriptor> descriptors;
+    for (uint32_t i = 0; i < columnFamilies; i++) {
+      rocksdb::ColumnFamilyOptions columnFamilyOptions(options);
+      SetColumnFamilyOptions(columnFamilyOptions, config, blockCache);
+      descriptors.emplace_back(std::to_string(i), columnFamilyOptions);
+    }
+    sink = sink + descriptors.size();
+  });
+}
+
+int main() {
+  const uint32_t count = 10000;
+  for (const size_t valueSize : {100, 1024}) {
+    TempDatabase db(count, valueSize);
+    BenchReadMany(db, count, valueSize, false);
+    BenchReadMany(db, count, valueSize, true);
+    if (valueSize == 100) BenchOutOfRange(db, count);
+    BenchEntry(count, valueSize);
+    BenchCopySlice(count, valueSize);
+  }
+  BenchOpenOptions(0, 0);
+  BenchOpenOptions(4, 0);
+  BenchOpenOptions(4, 2);
+  return 0;
+}
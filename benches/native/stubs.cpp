@@ -0,0 +1,106 @@
+/**
+ * Stubs of the N-API and libuv functions referenced by the native sources
+ * The benchmarks run without Node.js and never reach these, so each aborts
+ * with its name instead of leaving the symbol unresolved
+ * A function the sources start to use fails the link until it is added here
+ */
+
+#define NAPI_VERSION 3
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <node_api.h>
+#include <uv.h>
+
+[[noreturn]] static void Unavailable(const char* name) {
+  fprintf(stderr, "%s is not available without Node.js\n", name);
+  abort();
+}
+
+/**
+ * The declarations of `node_api.h` make these definitions `extern "C"` and
+ * check their signatures
+ */
+#define NAPI_STUB(name, ...) \
+  napi_status name(__VA_ARGS__) { Unavailable(#name); }
+
+NAPI_STUB(napi_adjust_external_memory, napi_env, int64_t, int64_t*)
+NAPI_STUB(napi_async_destroy, napi_env, napi_async_context)
+NAPI_STUB(napi_async_init, napi_env, napi_value, napi_value,
+          napi_async_context*)
+NAPI_STUB(napi_call_function, napi_env, napi_value, napi_value, size_t,
+          const napi_value*, napi_value*)
+NAPI_STUB(napi_close_callback_scope, napi_env, napi_callback_scope)
+NAPI_STUB(napi_close_handle_scope, napi_env, napi_handle_scope)
+NAPI_STUB(napi_create_array_with_length, napi_env, size_t, napi_value*)
+NAPI_STUB(napi_create_arraybuffer, napi_env, size_t, void**, napi_value*)
+NAPI_STUB(napi_create_async_work, napi_env, napi_value, napi_value,
+          napi_async_execute_callback, napi_async_complete_callback, void*,
+          napi_async_work*)
+NAPI_STUB(napi_create_buffer_copy, napi_env, size_t, const void*, void**,
+          napi_value*)
+NAPI_STUB(napi_create_double, napi_env, double, napi_value*)
+NAPI_STUB(napi_create_error, napi_env, napi_value, napi_value, napi_value*)
+NAPI_STUB(napi_create_external_buffer, napi_env, size_t, void*, napi_finalize,
+          void*, napi_value*)
+NAPI_STUB(napi_create_function, napi_env, const char*, size_t, napi_callback,
+          void*, napi_value*)
+NAPI_STUB(napi_create_int64, napi_env, int64_t, napi_value*)
+NAPI_STUB(napi_create_object, napi_env, napi_value*)
+NAPI_STUB(napi_create_reference, napi_env, napi_value, uint32_t, napi_ref*)
+NAPI_STUB(napi_create_string_utf8, napi_env, const char*, size_t, napi_value*)
+NAPI_STUB(napi_create_typedarray, napi_env, napi_typedarray_type, size_t,
+          napi_value, size_t, napi_value*)
+NAPI_STUB(napi_create_uint32, napi_env, uint32_t, napi_value*)
+NAPI_STUB(napi_delete_async_work, napi_env, napi_async_work)
+NAPI_STUB(napi_delete_reference, napi_env, napi_ref)
+NAPI_STUB(napi_fatal_exception, napi_env, napi_value)
+NAPI_STUB(napi_get_and_clear_last_exception, napi_env, napi_value*)
+NAPI_STUB(napi_get_array_length, napi_env, napi_value, uint32_t*)
+NAPI_STUB(napi_get_boolean, napi_env, bool, napi_value*)
+NAPI_STUB(napi_get_buffer_info, napi_env, napi_value, void**, size_t*)
+NAPI_STUB(napi_get_element, napi_env, napi_value, uint32_t, napi_value*)
+NAPI_STUB(napi_get_global, napi_env, napi_value*)
+NAPI_STUB(napi_get_named_property, napi_env, napi_value, const char*,
+          napi_value*)
+NAPI_STUB(napi_get_null, napi_env, napi_value*)
+NAPI_STUB(napi_get_reference_value, napi_env, napi_ref, napi_value*)
+NAPI_STUB(napi_get_undefined, napi_env, napi_value*)
+NAPI_STUB(napi_get_uv_event_loop, napi_env, struct uv_loop_s**)
+NAPI_STUB(napi_get_value_bool, napi_env, napi_value, bool*)
+NAPI_STUB(napi_get_value_double, napi_env, napi_value, double*)
+NAPI_STUB(napi_get_value_external, napi_env, napi_value, void**)
+NAPI_STUB(napi_get_value_int32, napi_env, napi_value, int32_t*)
+NAPI_STUB(napi_get_value_int64, napi_env, napi_value, int64_t*)
+NAPI_STUB(napi_get_value_string_utf8, napi_env, napi_value, char*, size_t,
+          size_t*)
+NAPI_STUB(napi_get_value_uint32, napi_env, napi_value, uint32_t*)
+NAPI_STUB(napi_has_named_property, napi_env, napi_value, const char*, bool*)
+NAPI_STUB(napi_is_buffer, napi_env, napi_value, bool*)
+NAPI_STUB(napi_is_exception_pending, napi_env, bool*)
+NAPI_STUB(napi_new_instance, napi_env, napi_value, size_t, const napi_value*,
+          napi_value*)
+NAPI_STUB(napi_open_callback_scope, napi_env, napi_value, napi_async_context,
+          napi_callback_scope*)
+NAPI_STUB(napi_open_handle_scope, napi_env, napi_handle_scope*)
+NAPI_STUB(napi_queue_async_work, napi_env, napi_async_work)
+NAPI_STUB(napi_reference_ref, napi_env, napi_ref, uint32_t*)
+NAPI_STUB(napi_reference_unref, napi_env, napi_ref, uint32_t*)
+NAPI_STUB(napi_set_element, napi_env, napi_value, uint32_t, napi_value)
+NAPI_STUB(napi_set_named_property, napi_env, napi_value, const char*,
+          napi_value)
+NAPI_STUB(napi_throw_error, napi_env, const char*, const char*)
+NAPI_STUB(napi_typeof, napi_env, napi_value, napi_valuetype*)
+
+int uv_async_init(uv_loop_t*, uv_async_t*, uv_async_cb) {
+  Unavailable("uv_async_init");
+}
+
+int uv_async_send(uv_async_t*) { Unavailable("uv_async_send"); }
+
+void uv_close(uv_handle_t*, uv_close_cb) { Unavailable("uv_close"); }
+
+void uv_ref(uv_handle_t*) { Unavailable("uv_ref"); }
+
+void uv_unref(uv_handle_t*) { Unavailable("uv_unref"); }
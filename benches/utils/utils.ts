@@ -58,4 +58,75 @@ const suiteCommon = [
   }),
 ];
 
-export { suiteCommon };
+/**
+ * Zipfian distribution over `[0, items)` as generated by YCSB
+ * Lower items are the most popular, see "Quickly Generating Billion-Record
+ * Synthetic Databases" by Gray et al.
+ */
+class ZipfianGenerator {
+  protected items: number;
+  protected theta: number;
+  protected zeta2: number;
+  protected zetaN: number;
+  protected alpha: number;
+  protected eta: number;
+
+  public constructor(items: number, theta: number = 0.99) {
+    this.items = items;
+    this.theta = theta;
+    this.zeta2 = this.zeta(2);
+    this.zetaN = this.zeta(items);
+    this.alpha = 1 / (1 - theta);
+    this.eta =
+      (1 - Math.pow(2 / items, 1 - theta)) / (1 - this.zeta2 / this.zetaN);
+  }
+
+  public next(): number {
+    const u = Math.random();
+    const uz = u * this.zetaN;
+    if (uz < 1) return 0;
+    if (uz < 1 + Math.pow(0.5, this.theta)) return 1;
+    return Math.floor(
+      this.items * Math.pow(this.eta * u - this.eta + 1, this.alpha),
+    );
+  }
+
+  protected zeta(n: number): number {
+    let sum = 0;
+    for (let i = 1; i <= n; i++) {
+      sum += 1 / Math.pow(i, this.theta);
+    }
+    return sum;
+  }
+}
+
+/**
+ * Zipfian distribution with the popular items scattered over the key
+ * space, so they do not share blocks
+ */
+class ScrambledZipfianGenerator extends ZipfianGenerator {
+  protected range: number;
+
+  public constructor(range: number, theta?: number) {
+    super(range, theta);
+    this.range = range;
+  }
+
+  public next(): number {
+    return fnv1a(super.next()) % this.range;
+  }
+}
+
+/**
+ * 32-bit FNV-1a of the bytes of a non-negative integer
+ */
+function fnv1a(n: number): number {
+  let hash = 0x811c9dc5;
+  for (let i = 0; i < 4; i++) {
+    hash ^= (n >>> (i * 8)) & 0xff;
+    hash = Math.imul(hash, 0x01000193) >>> 0;
+  }
+  return hash;
+}
+
+export { suiteCommon, ZipfianGenerator, ScrambledZipfianGenerator };
@@ -1,4 +1,8 @@
 {
+  'variables': {
+    # Builds the native microbenchmarks with `-Dbuild_bench=1`
+    'build_bench%': 0
+  },
   'targets': [{
     'target_name': 'native',
     'include_dirs': [
@@ -11,8 +15,11 @@
       './src/native/napi/batch.cpp',
       './src/native/napi/database.cpp',
       './src/native/napi/debug.cpp',
+      './src/native/napi/executor.cpp',
       './src/native/napi/index.cpp',
       './src/native/napi/iterator.cpp',
+      './src/native/napi/keypath.cpp',
+      './src/native/napi/latency.cpp',
       './src/native/napi/snapshot.cpp',
       './src/native/napi/transaction.cpp',
       './src/native/napi/utils.cpp',
@@ -93,5 +100,53 @@
         'cflags_cc': [ '-mfloat-abi=hard '],
       }],
     ]
-  }]
+  }],
+  'conditions': [
+    ['build_bench==1', {
+      'targets': [{
+        'target_name': 'native_bench',
+        'type': 'executable',
+        'include_dirs': [
+          "<!(node -e \"require('napi-macros')\")"
+        ],
+        'dependencies': [
+          '<(module_root_dir)/deps/rocksdb/rocksdb.gyp:rocksdb'
+        ],
+        # Everything except the module registration in `index.cpp`, with
+        # N-API and libuv stubbed out in `stubs.cpp`
+        'sources': [
+          './benches/native/bench.cpp',
+          './benches/native/stubs.cpp',
+          './src/native/napi/batch.cpp',
+          './src/native/napi/database.cpp',
+          './src/native/napi/debug.cpp',
+          './src/native/napi/executor.cpp',
+          './src/native/napi/iterator.cpp',
+          './src/native/napi/keypath.cpp',
+          './src/native/napi/latency.cpp',
+          './src/native/napi/snapshot.cpp',
+          './src/native/napi/transaction.cpp',
+          './src/native/napi/utils.cpp',
+          './src/native/napi/worker.cpp',
+          './src/native/napi/workers/batch_workers.cpp',
+          './src/native/napi/workers/database_workers.cpp',
+          './src/native/napi/workers/iterator_workers.cpp',
+          './src/native/napi/workers/transaction_workers.cpp',
+          './src/native/napi/workers/snapshot_workers.cpp'
+        ],
+        'conditions': [
+          ['OS=="linux"', {
+            'cflags_cc': [ '-std=c++17' ],
+            'cflags_cc!': [ '-fno-exceptions' ],
+          }],
+          ['OS=="mac"', {
+            'xcode_settings': {
+              'MACOSX_DEPLOYMENT_TARGET': '10.13',
+              'OTHER_CPLUSPLUSFLAGS': [ '-std=c++17' ]
+            }
+          }],
+        ]
+      }]
+    }]
+  ]
 }
@@ -0,0 +1,67 @@
+{
+  "targets": [{
+    "target_name": "lz4",
+    "type": "static_library",
+    "standalone_static_library": 1,
+    "include_dirs": [
+      "lz4/lib"
+    ],
+    "direct_dependent_settings": {
+      "include_dirs": [
+        "lz4/lib"
+      ]
+    },
+    "defines": [
+      # Keeps the bundled xxhash apart from other copies in the process
+      "XXH_NAMESPACE=LZ4_"
+    ],
+    "conditions": [
+      ["OS == 'win'", {
+        "msvs_settings": {
+          "VCCLCompilerTool": {
+            "DisableSpecificWarnings": [ "4244", "4267" ]
+          }
+        }
+      }],
+      ["OS == 'linux'", {
+        "cflags": [ "-fPIC" ],
+        "cflags!": [ "-fno-tree-vrp" ]
+      }],
+      ["OS == 'mac'", {
+        "xcode_settings": {
+          # Set minimum target version because we're building on newer
+          "MACOSX_DEPLOYMENT_TARGET": "10.7",
+
+          # Build universal binary to support M1 (Apple silicon)
+          "OTHER_CFLAGS": [
+            "-arch x86_64",
+            "-arch arm64"
+          ]
+        }
+      }],
+      ["OS == 'android'", {
+        "cflags": [ "-fPIC" ],
+        "cflags!": [
+          "-fno-tree-vrp",
+          "-mfloat-abi=hard",
+          "-fPIE"
+        ]
+      }],
+      ["target_arch == 'arm'", {
+        "cflags": [
+          "-mfloat-abi=hard"
+        ]
+      }]
+    ],
+    "sources": [
+      "lz4/lib/lz4.c",
+      "lz4/lib/lz4.h",
+      "lz4/lib/lz4frame.c",
+      "lz4/lib/lz4frame.h",
+      "lz4/lib/lz4hc.c",
+      "lz4/lib/lz4hc.h",
+      "lz4/lib/xxhash.c",
+      "lz4/lib/xxhash.h"
+    ]
+  }]
+}
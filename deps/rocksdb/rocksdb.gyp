@@ -6,6 +6,8 @@
   , 'standalone_static_library': 1
   , 'dependencies': [
         '../snappy/snappy.gyp:snappy'
+      , '../lz4/lz4.gyp:lz4'
+      , '../zstd/zstd.gyp:zstd'
     ]
   , 'direct_dependent_settings': {
         'include_dirs': [
@@ -14,6 +16,8 @@
     }
   , 'defines': [
         'SNAPPY=1'
+      , 'LZ4=1'
+      , 'ZSTD=1'
     ]
   , 'include_dirs': [
         'rocksdb/'
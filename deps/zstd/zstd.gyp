@@ -0,0 +1,94 @@
+{
+  "targets": [{
+    "target_name": "zstd",
+    "type": "static_library",
+    "standalone_static_library": 1,
+    "include_dirs": [
+      "zstd/lib",
+      "zstd/lib/common",
+      "zstd/lib/dictBuilder"
+    ],
+    "direct_dependent_settings": {
+      "include_dirs": [
+        "zstd/lib",
+        "zstd/lib/dictBuilder"
+      ]
+    },
+    "defines": [
+      # The assembly Huffman decoder is not portable across our toolchains
+      "ZSTD_DISABLE_ASM=1",
+      "XXH_NAMESPACE=ZSTD_"
+    ],
+    "conditions": [
+      ["OS == 'win'", {
+        "msvs_settings": {
+          "VCCLCompilerTool": {
+            "DisableSpecificWarnings": [ "4244", "4267", "4146" ]
+          }
+        }
+      }],
+      ["OS == 'linux'", {
+        "cflags": [ "-fPIC" ],
+        "cflags!": [ "-fno-tree-vrp" ]
+      }],
+      ["OS == 'mac'", {
+        "xcode_settings": {
+          # Set minimum target version because we're building on newer
+          "MACOSX_DEPLOYMENT_TARGET": "10.7",
+
+          # Build universal binary to support M1 (Apple silicon)
+          "OTHER_CFLAGS": [
+            "-arch x86_64",
+            "-arch arm64"
+          ]
+        }
+      }],
+      ["OS == 'android'", {
+        "cflags": [ "-fPIC" ],
+        "cflags!": [
+          "-fno-tree-vrp",
+          "-mfloat-abi=hard",
+          "-fPIE"
+        ]
+      }],
+      ["target_arch == 'arm'", {
+        "cflags": [
+          "-mfloat-abi=hard"
+        ]
+      }]
+    ],
+    "sources": [
+      "zstd/lib/common/debug.c",
+      "zstd/lib/common/entropy_common.c",
+      "zstd/lib/common/error_private.c",
+      "zstd/lib/common/fse_decompress.c",
+      "zstd/lib/common/pool.c",
+      "zstd/lib/common/threading.c",
+      "zstd/lib/common/xxhash.c",
+      "zstd/lib/common/zstd_common.c",
+      "zstd/lib/compress/fse_compress.c",
+      "zstd/lib/compress/hist.c",
+      "zstd/lib/compress/huf_compress.c",
+      "zstd/lib/compress/zstd_compress.c",
+      "zstd/lib/compress/zstd_compress_literals.c",
+      "zstd/lib/compress/zstd_compress_sequences.c",
+      "zstd/lib/compress/zstd_compress_superblock.c",
+      "zstd/lib/compress/zstd_double_fast.c",
+      "zstd/lib/compress/zstd_fast.c",
+      "zstd/lib/compress/zstd_lazy.c",
+      "zstd/lib/compress/zstd_ldm.c",
+      "zstd/lib/compress/zstd_opt.c",
+      "zstd/lib/compress/zstdmt_compress.c",
+      "zstd/lib/decompress/huf_decompress.c",
+      "zstd/lib/decompress/zstd_ddict.c",
+      "zstd/lib/decompress/zstd_decompress.c",
+      "zstd/lib/decompress/zstd_decompress_block.c",
+      "zstd/lib/dictBuilder/cover.c",
+      "zstd/lib/dictBuilder/divsufsort.c",
+      "zstd/lib/dictBuilder/fastcover.c",
+      "zstd/lib/dictBuilder/zdict.c",
+      "zstd/lib/zstd.h",
+      "zstd/lib/dictBuilder/zdict.h"
+    ]
+  }]
+}
@@ -36,8 +36,15 @@ class DBIterator<K extends KeyPath | undefined, V> {
   protected _iterator: RocksDBIterator<Buffer, Buffer>;
   protected first: boolean = true;
   protected finished: boolean = false;
-  protected cache: Array<[Buffer, Buffer]> = [];
+  /**
+   * Packed batch from `iteratorNextvPacked`
+   * Entries are sliced out of it lazily
+   * Keys are already split into their decoded parts by the native iterator
+   */
+  protected cacheData: Buffer = Buffer.alloc(0);
+  protected cacheOffsets: Uint32Array = new Uint32Array(0);
   protected cachePos: number = 0;
+  protected cacheEnd: number = 0;
   protected lock: Lock = new Lock();
 
   public constructor(
@@ -81,7 +88,10 @@ class DBIterator<K extends KeyPath | undefined, V> {
       this._transaction = transaction;
       this._iterator = rocksdbP.transactionIteratorInit(
         transaction.transaction,
-        options_ as RocksDBIteratorOptions<RocksDBTransactionSnapshot> & {
+        {
+          ...options_,
+          keyPath: true,
+        } as RocksDBIteratorOptions<RocksDBTransactionSnapshot> & {
           keyEncoding: 'buffer';
           valueEncoding: 'buffer';
         },
@@ -90,7 +100,11 @@ class DBIterator<K extends KeyPath | undefined, V> {
     } else {
       this._iterator = rocksdbP.iteratorInit(
         db.db,
-        options_ as RocksDBIteratorOptions<RocksDBSnapshot> & {
+        {
+          ...options_,
+          keyPath: true,
+          prefetch: true,
+        } as RocksDBIteratorOptions<RocksDBSnapshot> & {
           keyEncoding: 'buffer';
           valueEncoding: 'buffer';
         },
@@ -118,7 +132,8 @@ class DBIterator<K extends KeyPath | undefined, V> {
 
   public async destroy(): Promise<void> {
     this.logger.debug(`Destroying ${this.constructor.name}`);
-    this.cache = [];
+    this.cacheData = Buffer.alloc(0);
+    this.cacheOffsets = new Uint32Array(0);
     await rocksdbP.iteratorClose(this._iterator);
     if (this._transaction != null) {
       this._transaction.iteratorRefs.delete(this);
@@ -139,8 +154,10 @@ class DBIterator<K extends KeyPath | undefined, V> {
     );
     this.first = true;
     this.finished = false;
-    this.cache = [];
+    this.cacheData = Buffer.alloc(0);
+    this.cacheOffsets = new Uint32Array(0);
     this.cachePos = 0;
+    this.cacheEnd = 0;
   }
 
   @ready(new errors.ErrorDBIteratorDestroyed(), true)
@@ -149,23 +166,28 @@ class DBIterator<K extends KeyPath | undefined, V> {
   }
 
   protected async _next(): Promise<[K, V] | undefined> {
-    if (this.cachePos < this.cache.length) {
-      const entry = this.cache[this.cachePos];
-      const result = this.processEntry(entry);
-      this.cachePos += 1;
-      return result;
+    if (this.cachePos < this.cacheOffsets.length) {
+      return this.processEntry(this.cacheEntry());
     } else if (this.finished) {
       return;
     }
-    let entries: Array<[Buffer, Buffer]>, finished: boolean;
+    let data: Buffer, offsets: Uint32Array, finished: boolean;
     if (this.first) {
-      [entries, finished] = await rocksdbP.iteratorNextv(this._iterator, 1);
+      [data, offsets, finished] = await rocksdbP.iteratorNextvPacked(
+        this._iterator,
+        1,
+      );
       this.first = false;
     } else {
-      [entries, finished] = await rocksdbP.iteratorNextv(this._iterator, 1000);
+      [data, offsets, finished] = await rocksdbP.iteratorNextvPacked(
+        this._iterator,
+        1000,
+      );
     }
     this.cachePos = 0;
-    this.cache = entries;
+    this.cacheEnd = 0;
+    this.cacheData = data;
+    this.cacheOffsets = offsets;
     this.finished = finished;
     // If the entries are empty and finished is false
     // then this will enter a retry loop
@@ -186,7 +208,29 @@ class DBIterator<K extends KeyPath | undefined, V> {
     }
   }
 
-  protected async processEntry(entry: [Buffer, Buffer]): Promise<[K, V]> {
+  /**
+   * Slices the next entry out of the packed batch
+   * Each entry is laid out as the number of key parts, the end of each key
+   * part and then the end of the value
+   * These are views of the batch buffer and are not copied
+   */
+  protected cacheEntry(): [Array<Buffer>, Buffer] {
+    const partsCount = this.cacheOffsets[this.cachePos++];
+    const parts: Array<Buffer> = [];
+    for (let i = 0; i < partsCount; i++) {
+      const partEnd = this.cacheOffsets[this.cachePos++];
+      parts.push(this.cacheData.subarray(this.cacheEnd, partEnd));
+      this.cacheEnd = partEnd;
+    }
+    const valueEnd = this.cacheOffsets[this.cachePos++];
+    const value = this.cacheData.subarray(this.cacheEnd, valueEnd);
+    this.cacheEnd = valueEnd;
+    return [parts, value];
+  }
+
+  protected async processEntry(
+    entry: [Array<Buffer>, Buffer],
+  ): Promise<[K, V]> {
     let keyPath: KeyPath | undefined;
     let value: Buffer | V | undefined;
     // If keys were false, leveldb returns empty buffer
@@ -194,7 +238,7 @@ class DBIterator<K extends KeyPath | undefined, V> {
       keyPath = undefined;
     } else {
       // Truncate level path so the returned key is relative to the level path
-      keyPath = utils.parseKey(entry[0]).slice(this.levelPath.length);
+      keyPath = entry[0].slice(this.levelPath.length);
       if (this._options.keyAsBuffer === false) {
         keyPath = keyPath.map((k) => k.toString('utf-8'));
       }
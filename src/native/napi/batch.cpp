@@ -22,13 +22,15 @@ Batch::~Batch() {
   LOG_DEBUG("Batch:Destroyed Batch\n");
 }
 
-void Batch::Put(rocksdb::Slice key, rocksdb::Slice value) {
-  batch_->Put(key, value);
+void Batch::Put(rocksdb::ColumnFamilyHandle* columnFamily, rocksdb::Slice key,
+                rocksdb::Slice value) {
+  batch_->Put(columnFamily, key, value);
   hasData_ = true;
 }
 
-void Batch::Del(rocksdb::Slice key) {
-  batch_->Delete(key);
+void Batch::Del(rocksdb::ColumnFamilyHandle* columnFamily,
+                rocksdb::Slice key) {
+  batch_->Delete(columnFamily, key);
   hasData_ = true;
 }
 
@@ -18,9 +18,10 @@ struct Batch {
 
   ~Batch();
 
-  void Put(rocksdb::Slice key, rocksdb::Slice value);
+  void Put(rocksdb::ColumnFamilyHandle* columnFamily, rocksdb::Slice key,
+           rocksdb::Slice value);
 
-  void Del(rocksdb::Slice key);
+  void Del(rocksdb::ColumnFamilyHandle* columnFamily, rocksdb::Slice key);
 
   void Clear();
 
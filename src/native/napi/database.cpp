@@ -2,28 +2,37 @@
 
 #include "database.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <set>
 #include <string>
 #include <vector>
 
 #include <napi-macros.h>
 #include <node_api.h>
 #include <rocksdb/db.h>
+#include <rocksdb/metadata.h>
 #include <rocksdb/status.h>
 #include <rocksdb/slice.h>
 #include <rocksdb/options.h>
 #include <rocksdb/snapshot.h>
+#include <rocksdb/table_properties.h>
 #include <rocksdb/utilities/optimistic_transaction_db.h>
 
 #include "debug.h"
+#include "executor.h"
 #include "worker.h"
 
 Database::Database()
     : db_(nullptr),
+      defaultColumnFamily_(nullptr),
+      executor_(nullptr),
       isClosing_(false),
       hasClosed_(false),
       currentIteratorId_(0),
       currentTransactionId_(0),
       closeWorker_(nullptr),
+      syncWriting_(false),
       ref_(nullptr),
       pendingWork_(0) {
   LOG_DEBUG("Database:Constructing Database\n");
@@ -33,7 +42,9 @@ Database::Database()
 Database::~Database() {
   LOG_DEBUG("Database:Destroying Database\n");
   assert(hasClosed_);
+  assert(executor_ == nullptr);
   delete db_;
+  for (ColumnFamily* columnFamily : allColumnFamilies_) delete columnFamily;
   LOG_DEBUG("Database:Destroyed Database\n");
 }
 
@@ -48,43 +59,89 @@ void Database::Detach(napi_env env) {
   ref_ = nullptr;
 }
 
-rocksdb::Status Database::Open(const rocksdb::Options& options,
-                               const char* location) {
-  return rocksdb::OptimisticTransactionDB::Open(options, location, &db_);
+rocksdb::Status Database::Open(
+    const rocksdb::Options& options, const char* location,
+    std::vector<rocksdb::ColumnFamilyDescriptor> columnFamilies) {
+  std::set<std::string> names;
+  for (const rocksdb::ColumnFamilyDescriptor& c : columnFamilies) {
+    names.insert(c.name);
+  }
+  if (names.count(rocksdb::kDefaultColumnFamilyName) == 0) {
+    columnFamilies.emplace_back(rocksdb::kDefaultColumnFamilyName,
+                                rocksdb::ColumnFamilyOptions(options));
+  }
+  std::vector<std::string> existing;
+  // This fails when the database does not exist yet
+  if (rocksdb::DB::ListColumnFamilies(options, location, &existing).ok()) {
+    for (const std::string& name : existing) {
+      if (names.count(name) == 0 && name != rocksdb::kDefaultColumnFamilyName) {
+        columnFamilies.emplace_back(name,
+                                    rocksdb::ColumnFamilyOptions(options));
+      }
+    }
+  }
+  std::vector<rocksdb::ColumnFamilyHandle*> handles;
+  rocksdb::Status status = rocksdb::OptimisticTransactionDB::Open(
+      rocksdb::DBOptions(options), location, columnFamilies, &handles, &db_);
+  if (!status.ok()) return status;
+  for (size_t i = 0; i < handles.size(); i++) {
+    ColumnFamily* columnFamily = new ColumnFamily{
+        handles[i], columnFamilies[i].options.prefix_extractor};
+    columnFamilies_[columnFamilies[i].name] = columnFamily;
+    allColumnFamilies_.push_back(columnFamily);
+    if (columnFamilies[i].name == rocksdb::kDefaultColumnFamilyName) {
+      defaultColumnFamily_ = columnFamily;
+    }
+  }
+  return status;
 }
 
 void Database::Close() {
   LOG_DEBUG("Database:Calling %s\n", __func__);
   if (hasClosed_) return;
   hasClosed_ = true;
+  if (db_ != nullptr) {
+    // Handles have to be destroyed before the database
+    for (ColumnFamily* columnFamily : allColumnFamilies_) {
+      db_->DestroyColumnFamilyHandle(columnFamily->handle_);
+      columnFamily->handle_ = nullptr;
+    }
+  }
   delete db_;
   db_ = nullptr;
   LOG_DEBUG("Database:Called %s\n", __func__);
 }
 
 rocksdb::Status Database::Put(const rocksdb::WriteOptions& options,
+                              rocksdb::ColumnFamilyHandle* columnFamily,
                               rocksdb::Slice key, rocksdb::Slice value) {
   assert(!hasClosed_);
-  return db_->Put(options, key, value);
+  return db_->Put(options, columnFamily, key, value);
 }
 
 rocksdb::Status Database::Get(const rocksdb::ReadOptions& options,
-                              rocksdb::Slice key, std::string& value) {
+                              rocksdb::ColumnFamilyHandle* columnFamily,
+                              rocksdb::Slice key,
+                              rocksdb::PinnableSlice* value) {
   assert(!hasClosed_);
-  return db_->Get(options, key, &value);
+  return db_->Get(options, columnFamily, key, value);
 }
 
-std::vector<rocksdb::Status> Database::MultiGet(
-    const rocksdb::ReadOptions& options,
-    const std::vector<rocksdb::Slice>& keys, std::vector<std::string>& values) {
+void Database::MultiGet(const rocksdb::ReadOptions& options,
+                        rocksdb::ColumnFamilyHandle* columnFamily,
+                        const size_t numKeys, const rocksdb::Slice* keys,
+                        rocksdb::PinnableSlice* values,
+                        rocksdb::Status* statuses, const bool sortedInput) {
   assert(!hasClosed_);
-  return db_->MultiGet(options, keys, &values);
+  db_->MultiGet(options, columnFamily, numKeys, keys, values, statuses,
+                sortedInput);
 }
 
 rocksdb::Status Database::Del(const rocksdb::WriteOptions& options,
+                              rocksdb::ColumnFamilyHandle* columnFamily,
                               rocksdb::Slice key) {
   assert(!hasClosed_);
-  return db_->Delete(options, key);
+  return db_->Delete(options, columnFamily, key);
 }
 
 rocksdb::Status Database::WriteBatch(const rocksdb::WriteOptions& options,
@@ -100,6 +157,72 @@ uint64_t Database::ApproximateSize(const rocksdb::Range* range) {
   return size;
 }
 
+bool Database::EstimateCount(ColumnFamily* columnFamily,
+                             const rocksdb::Range& range, uint64_t* count) {
+  assert(!hasClosed_);
+  rocksdb::ColumnFamilyHandle* handle = columnFamily->handle_;
+  // Memtable range deletions are not visible in the memtable stats, they
+  // are out of the memtables once a table holds a later sequence number
+  const uint64_t rangeDeletionSequence =
+      columnFamily->rangeDeletionSequence_.load();
+  if (rangeDeletionSequence > 0) {
+    rocksdb::ColumnFamilyMetaData metadata;
+    db_->GetColumnFamilyMetaData(handle, &metadata);
+    uint64_t flushedSequence = 0;
+    for (const rocksdb::LevelMetaData& level : metadata.levels) {
+      for (const rocksdb::SstFileMetaData& file : level.files) {
+        flushedSequence = std::max(flushedSequence, file.largest_seqno);
+      }
+    }
+    if (flushedSequence < rangeDeletionSequence) return false;
+  }
+  uint64_t memTableCount = 0;
+  uint64_t memTableSize = 0;
+  db_->GetApproximateMemTableStats(handle, range, &memTableCount,
+                                   &memTableSize);
+  rocksdb::SizeApproximationOptions options;
+  options.include_memtabtles = false;
+  options.include_files = true;
+  uint64_t filesSize = 0;
+  if (!db_->GetApproximateSizes(options, handle, &range, 1, &filesSize).ok() ||
+      filesSize == 0) {
+    *count = memTableCount;
+    return true;
+  }
+  rocksdb::TablePropertiesCollection tables;
+  if (!db_->GetPropertiesOfTablesInRange(handle, &range, 1, &tables).ok()) {
+    *count = memTableCount;
+    return true;
+  }
+  uint64_t entries = 0;
+  uint64_t dataSize = 0;
+  for (const auto& table : tables) {
+    if (table.second->num_range_deletions > 0) return false;
+    entries += table.second->num_entries - table.second->num_deletions;
+    dataSize += table.second->data_size;
+  }
+  if (dataSize == 0) {
+    *count = memTableCount;
+    return true;
+  }
+  // Products of sizes and entries can overflow 64 bits
+  *count = memTableCount +
+           static_cast<uint64_t>(static_cast<double>(filesSize) * entries /
+                                 dataSize);
+  return true;
+}
+
+void Database::RangeDeleted(ColumnFamily* columnFamily) {
+  assert(!hasClosed_);
+  // The latest sequence number is at least that of the range deletion
+  const uint64_t sequence = db_->GetLatestSequenceNumber();
+  uint64_t previous = columnFamily->rangeDeletionSequence_.load();
+  while (previous < sequence &&
+         !columnFamily->rangeDeletionSequence_.compare_exchange_weak(
+             previous, sequence)) {
+  }
+}
+
 void Database::CompactRange(const rocksdb::Slice* start,
                             const rocksdb::Slice* end) {
   assert(!hasClosed_);
@@ -117,9 +240,23 @@ const rocksdb::Snapshot* Database::NewSnapshot() {
   return db_->GetSnapshot();
 }
 
-rocksdb::Iterator* Database::NewIterator(rocksdb::ReadOptions& options) {
+rocksdb::Iterator* Database::NewIterator(
+    rocksdb::ReadOptions& options, rocksdb::ColumnFamilyHandle* columnFamily) {
   assert(!hasClosed_);
-  return db_->NewIterator(options);
+  return db_->NewIterator(options, columnFamily);
+}
+
+rocksdb::Status Database::DropColumnFamily(ColumnFamily* columnFamily) {
+  assert(!hasClosed_);
+  rocksdb::Status status = db_->DropColumnFamily(columnFamily->handle_);
+  if (!status.ok()) return status;
+  columnFamilies_.erase(columnFamily->handle_->GetName());
+  return status;
+}
+
+bool Database::OwnsColumnFamily(const ColumnFamily* columnFamily) const {
+  return std::find(allColumnFamilies_.begin(), allColumnFamilies_.end(),
+                   columnFamily) != allColumnFamilies_.end();
 }
 
 rocksdb::Transaction* Database::NewTransaction(rocksdb::WriteOptions& options) {
@@ -185,3 +322,32 @@ bool Database::HasPendingWork() const {
   // Initial JS reference count starts at 0
   return pendingWork_ > 0;
 }
+
+void Database::QueueSyncWrite(napi_env env, WriteWorker* worker) {
+  if (syncWriting_) {
+    syncWrites_.push_back(worker);
+    return;
+  }
+  syncWriting_ = true;
+  worker->leader_ = true;
+  worker->BaseWorker::Queue(env);
+}
+
+void Database::CompleteSyncWrite(napi_env env) {
+  syncWriting_ = false;
+  if (syncWrites_.empty()) return;
+  WriteWorker* leader = syncWrites_.front();
+  leader->followers_.assign(syncWrites_.begin() + 1, syncWrites_.end());
+  syncWrites_.clear();
+  syncWriting_ = true;
+  leader->leader_ = true;
+  leader->BaseWorker::Queue(env);
+}
+
+void Database::StopExecutor(const bool complete) {
+  if (executor_ == nullptr) return;
+  Executor* executor = executor_;
+  // Workers completed while stopping must queue onto the libuv thread pool
+  executor_ = nullptr;
+  executor->Stop(complete);
+}
@@ -4,15 +4,23 @@
 #define NAPI_VERSION 3
 #endif
 
+#include <atomic>
+#include <cstdint>
 #include <string>
 #include <map>
+#include <memory>
 #include <vector>
 
 #include <node_api.h>
 #include <rocksdb/db.h>
+#include <rocksdb/cache.h>
+#include <rocksdb/compression_type.h>
 #include <rocksdb/status.h>
 #include <rocksdb/slice.h>
 #include <rocksdb/options.h>
+#include <rocksdb/slice_transform.h>
+#include <rocksdb/statistics.h>
+#include <rocksdb/table.h>
 #include <rocksdb/utilities/optimistic_transaction_db.h>
 
 /**
@@ -22,6 +30,95 @@ struct Iterator;
 struct Transaction;
 struct Snapshot;
 struct BaseWorker;
+struct WriteWorker;
+struct Executor;
+
+/**
+ * Column family opened with the database
+ * JS references these through externals, they are owned by the `Database`
+ * and live until it is destroyed
+ */
+struct ColumnFamily {
+  rocksdb::ColumnFamilyHandle* handle_;
+  /**
+   * LevelPath prefix extractor, iterators confined to a single prefix use
+   * prefix seeks
+   */
+  std::shared_ptr<const rocksdb::SliceTransform> prefixExtractor_;
+  /**
+   * Sequence number as of the latest `DeleteRange`, 0 if there was none
+   * since opening
+   */
+  std::atomic<uint64_t> rangeDeletionSequence_{0};
+};
+
+/**
+ * Per column family options given to `dbOpen`
+ * Defaults are those of `dbOpen`, otherwise RocksDB's
+ */
+struct ColumnFamilyConfig {
+  std::string name_ = rocksdb::kDefaultColumnFamilyName;
+  rocksdb::CompressionType compression_ = rocksdb::kSnappyCompression;
+  /**
+   * Compression of each level, empty uses `compression_` for all of them
+   */
+  std::vector<rocksdb::CompressionType> compressionPerLevel_;
+  /**
+   * `kDisableCompressionOption` leaves the bottommost level to the other
+   * compression options
+   */
+  rocksdb::CompressionType bottommostCompression_ =
+      rocksdb::kDisableCompressionOption;
+  int compressionLevel_ = rocksdb::CompressionOptions().level;
+  /**
+   * Dictionary compression is disabled at 0, ZSTD trains the dictionary on
+   * up to `compressionDictTrainBytes_` of samples
+   */
+  uint32_t compressionDictBytes_ = 0;
+  uint32_t compressionDictTrainBytes_ = 0;
+  uint64_t writeBufferSize_ = 4 << 20;
+  uint32_t maxWriteBufferNumber_ = 2;
+  uint32_t minWriteBufferNumberToMerge_ = 1;
+  uint32_t blockSize_ = 4096;
+  uint32_t blockRestartInterval_ = 16;
+  uint32_t prefixLevels_ = 0;
+  /**
+   * Two level index with partitioned filters, only the top level has to be
+   * in memory
+   */
+  bool partitionedIndexFilters_ = false;
+  /**
+   * Index and filter blocks go through the block cache at high priority
+   * instead of being held by table readers
+   */
+  bool cacheIndexAndFilterBlocks_ = false;
+  bool pinL0FilterAndIndexBlocks_ = false;
+  bool dataBlockHashIndex_ = false;
+  /**
+   * 0 disables filters
+   */
+  uint32_t filterBitsPerKey_ = 10;
+  /**
+   * Ribbon instead of bloom filters, only used from format version 5
+   */
+  bool ribbonFilter_ = false;
+  uint32_t formatVersion_ = rocksdb::BlockBasedTableOptions().format_version;
+  /**
+   * Values of at least `minBlobSize_` are written to blob files and only
+   * referenced from tables, so compactions do not rewrite them
+   */
+  bool enableBlobFiles_ = false;
+  uint64_t minBlobSize_ = rocksdb::ColumnFamilyOptions().min_blob_size;
+  uint64_t blobFileSize_ = rocksdb::ColumnFamilyOptions().blob_file_size;
+  rocksdb::CompressionType blobCompression_ = rocksdb::kNoCompression;
+  /**
+   * Compactions relocate the live values of the oldest
+   * `blobGarbageCollectionAgeCutoff_` of blob files, so they can be deleted
+   */
+  bool enableBlobGarbageCollection_ = false;
+  double blobGarbageCollectionAgeCutoff_ =
+      rocksdb::ColumnFamilyOptions().blob_garbage_collection_age_cutoff;
+};
 
 /**
  * Owns the RocksDB storage, cache, filter policy and iterators.
@@ -54,7 +151,14 @@ struct Database {
    */
   void Detach(napi_env env);
 
-  rocksdb::Status Open(const rocksdb::Options& options, const char* location);
+  /**
+   * Opens the database with `columnFamilies`
+   * Existing column families that are not in `columnFamilies` are opened
+   * with the database's options, since RocksDB requires all of them
+   */
+  rocksdb::Status Open(
+      const rocksdb::Options& options, const char* location,
+      std::vector<rocksdb::ColumnFamilyDescriptor> columnFamilies);
 
   /**
    * Close the database
@@ -62,30 +166,76 @@ struct Database {
    */
   void Close();
 
-  rocksdb::Status Put(const rocksdb::WriteOptions& options, rocksdb::Slice key,
-                      rocksdb::Slice value);
+  rocksdb::Status Put(const rocksdb::WriteOptions& options,
+                      rocksdb::ColumnFamilyHandle* columnFamily,
+                      rocksdb::Slice key, rocksdb::Slice value);
 
-  rocksdb::Status Get(const rocksdb::ReadOptions& options, rocksdb::Slice key,
-                      std::string& value);
+  /**
+   * Get a value
+   * The value may pin a block of the block cache until it is reset
+   */
+  rocksdb::Status Get(const rocksdb::ReadOptions& options,
+                      rocksdb::ColumnFamilyHandle* columnFamily,
+                      rocksdb::Slice key, rocksdb::PinnableSlice* value);
 
-  std::vector<rocksdb::Status> MultiGet(const rocksdb::ReadOptions& options,
-                                        const std::vector<rocksdb::Slice>& keys,
-                                        std::vector<std::string>& values);
+  /**
+   * Get multiple values with batched lookups
+   * Set `sortedInput` when `keys` are in ascending order
+   */
+  void MultiGet(const rocksdb::ReadOptions& options,
+                rocksdb::ColumnFamilyHandle* columnFamily,
+                const size_t numKeys, const rocksdb::Slice* keys,
+                rocksdb::PinnableSlice* values, rocksdb::Status* statuses,
+                const bool sortedInput = false);
 
-  rocksdb::Status Del(const rocksdb::WriteOptions& options, rocksdb::Slice key);
+  rocksdb::Status Del(const rocksdb::WriteOptions& options,
+                      rocksdb::ColumnFamilyHandle* columnFamily,
+                      rocksdb::Slice key);
 
   rocksdb::Status WriteBatch(const rocksdb::WriteOptions& options,
                              rocksdb::WriteBatch* batch);
 
   uint64_t ApproximateSize(const rocksdb::Range* range);
 
+  /**
+   * Estimates the number of keys in `range` without reading it
+   * Memtable entries are sampled, table file entries are derived from the
+   * approximate size of the range and the average entry size of the
+   * overlapping tables
+   * Overwritten and deleted keys that have not been compacted away are
+   * counted, and each end of the range is only accurate to a data block
+   * Returns false when range deletions may cover keys of `range`, as they
+   * hide any number of keys, the count has to be exact then
+   */
+  bool EstimateCount(ColumnFamily* columnFamily, const rocksdb::Range& range,
+                     uint64_t* count);
+
+  /**
+   * Records a `DeleteRange` written to `columnFamily`
+   * Until it has been flushed out of the memtables counts are not estimated
+   */
+  void RangeDeleted(ColumnFamily* columnFamily);
+
   void CompactRange(const rocksdb::Slice* start, const rocksdb::Slice* end);
 
   void GetProperty(const rocksdb::Slice& property, std::string* value);
 
   const rocksdb::Snapshot* NewSnapshot();
 
-  rocksdb::Iterator* NewIterator(rocksdb::ReadOptions& options);
+  rocksdb::Iterator* NewIterator(rocksdb::ReadOptions& options,
+                                 rocksdb::ColumnFamilyHandle* columnFamily);
+
+  /**
+   * Drops a column family, deleting all of its data
+   * Its handle stays valid until the database is closed
+   */
+  rocksdb::Status DropColumnFamily(ColumnFamily* columnFamily);
+
+  /**
+   * Whether `columnFamily` was opened by this database
+   * Handles of other databases must never reach RocksDB
+   */
+  bool OwnsColumnFamily(const ColumnFamily* columnFamily) const;
 
   rocksdb::Transaction* NewTransaction(rocksdb::WriteOptions& options);
 
@@ -109,7 +259,48 @@ struct Database {
 
   bool HasPendingWork() const;
 
+  /**
+   * Queues a synchronous write
+   * Only one group of synchronous writes is in flight at a time, the writes
+   * queued meanwhile form the next group, led by the first of them
+   */
+  void QueueSyncWrite(napi_env env, WriteWorker* worker);
+
+  /**
+   * Called by the leader of the group in flight once it is completed
+   */
+  void CompleteSyncWrite(napi_env env);
+
+  /**
+   * Stops and releases the executor, see `Executor::Stop`
+   * Repeating this call is idempotent
+   */
+  void StopExecutor(const bool complete = true);
+
   rocksdb::OptimisticTransactionDB* db_;
+  /**
+   * Block cache of the database, kept so that values pinning its blocks
+   * can outlive the database
+   */
+  std::shared_ptr<rocksdb::Cache> blockCache_;
+  /**
+   * Tickers and histograms of the database, only set when opened with
+   * `statistics`
+   */
+  std::shared_ptr<rocksdb::Statistics> statistics_;
+  /**
+   * Column families by name, the default column family is always present
+   * Dropped column families are no longer listed but are kept in
+   * `allColumnFamilies_`
+   */
+  std::map<std::string, ColumnFamily*> columnFamilies_;
+  std::vector<ColumnFamily*> allColumnFamilies_;
+  ColumnFamily* defaultColumnFamily_;
+  /**
+   * Runs the workers of the database and its transactions
+   * When this is null, workers run on the libuv thread pool
+   */
+  Executor* executor_;
   bool isClosing_;
   bool hasClosed_;
   uint32_t currentIteratorId_;
@@ -119,6 +310,11 @@ struct Database {
   std::map<uint32_t, Transaction*> transactions_;
   std::map<uint32_t, Snapshot*> snapshots_;
   BaseWorker* closeWorker_;
+  /**
+   * Synchronous writes waiting for the group in flight
+   */
+  std::vector<WriteWorker*> syncWrites_;
+  bool syncWriting_;
   napi_ref ref_;
 
  private:
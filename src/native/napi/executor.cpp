@@ -0,0 +1,157 @@
+#define NAPI_VERSION 3
+
+#include "executor.h"
+
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#include <node_api.h>
+#include <uv.h>
+
+#include "debug.h"
+#include "worker.h"
+
+Executor::Executor(napi_env env, const uint32_t threads,
+                   const uint32_t longThreads)
+    : env_(env),
+      stopping_(false),
+      pending_(0),
+      draining_(false),
+      closing_(false) {
+  LOG_DEBUG("Executor:Constructing Executor\n");
+  uv_loop_t* loop;
+  napi_get_uv_event_loop(env, &loop);
+  uv_async_init(loop, &async_, Executor::OnAsync);
+  async_.data = this;
+  uv_unref(reinterpret_cast<uv_handle_t*>(&async_));
+  for (uint32_t i = 0; i < threads; i++) {
+    shortLane_.threads_.emplace_back(&Executor::Run, this, &shortLane_);
+  }
+  for (uint32_t i = 0; i < longThreads; i++) {
+    longLane_.threads_.emplace_back(&Executor::Run, this, &longLane_);
+  }
+  LOG_DEBUG("Executor:Constructed Executor\n");
+}
+
+Executor::~Executor() {
+  LOG_DEBUG("Executor:Destroying Executor\n");
+  assert(shortLane_.threads_.empty() && longLane_.threads_.empty());
+  LOG_DEBUG("Executor:Destroyed Executor\n");
+}
+
+void Executor::Submit(napi_env env, BaseWorker* worker,
+                      const char* resourceName, const bool longRunning) {
+  assert(!closing_);
+  Task task;
+  task.worker_ = worker;
+  napi_value resource;
+  napi_create_object(env, &resource);
+  napi_create_reference(env, resource, 1, &task.resourceRef_);
+  napi_value asyncResourceName;
+  napi_create_string_utf8(env, resourceName, NAPI_AUTO_LENGTH,
+                          &asyncResourceName);
+  napi_async_init(env, resource, asyncResourceName, &task.context_);
+  if (pending_++ == 0) uv_ref(reinterpret_cast<uv_handle_t*>(&async_));
+  Lane* lane = &shortLane_;
+  if (longRunning && !longLane_.threads_.empty()) lane = &longLane_;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lane->queue_.push_back(task);
+  }
+  lane->available_.notify_one();
+}
+
+void Executor::Stop(const bool complete) {
+  LOG_DEBUG("Executor:Calling %s\n", __func__);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  shortLane_.available_.notify_all();
+  longLane_.available_.notify_all();
+  for (std::thread& thread : shortLane_.threads_) thread.join();
+  for (std::thread& thread : longLane_.threads_) thread.join();
+  shortLane_.threads_.clear();
+  longLane_.threads_.clear();
+  closing_ = true;
+  if (!complete) {
+    completed_.clear();
+    uv_close(reinterpret_cast<uv_handle_t*>(&async_), Executor::OnClose);
+  } else if (!draining_) {
+    // When stopped from a completion, the ongoing drain closes the handle
+    Drain();
+  }
+  LOG_DEBUG("Executor:Called %s\n", __func__);
+}
+
+void Executor::Run(Lane* lane) {
+  while (true) {
+    Task task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      lane->available_.wait(
+          lock, [this, lane] { return stopping_ || !lane->queue_.empty(); });
+      // Remaining workers are still executed when stopping
+      if (lane->queue_.empty()) return;
+      task = lane->queue_.front();
+      lane->queue_.pop_front();
+    }
+    task.worker_->Run();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      completed_.push_back(task);
+    }
+    uv_async_send(&async_);
+  }
+}
+
+void Executor::OnAsync(uv_async_t* handle) {
+  static_cast<Executor*>(handle->data)->Drain();
+}
+
+void Executor::OnClose(uv_handle_t* handle) {
+  delete static_cast<Executor*>(handle->data);
+}
+
+void Executor::Drain() {
+  draining_ = true;
+  while (true) {
+    std::deque<Task> completed;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      completed.swap(completed_);
+    }
+    if (completed.empty()) break;
+    for (Task& task : completed) {
+      Complete(task);
+      if (--pending_ == 0) uv_unref(reinterpret_cast<uv_handle_t*>(&async_));
+    }
+  }
+  draining_ = false;
+  if (closing_) {
+    uv_close(reinterpret_cast<uv_handle_t*>(&async_), Executor::OnClose);
+  }
+}
+
+void Executor::Complete(Task& task) {
+  napi_handle_scope scope;
+  napi_open_handle_scope(env_, &scope);
+  napi_value resource;
+  napi_get_reference_value(env_, task.resourceRef_, &resource);
+  napi_callback_scope callbackScope;
+  napi_open_callback_scope(env_, resource, task.context_, &callbackScope);
+  BaseWorker::Complete(env_, napi_ok, task.worker_);
+  // Like async work, exceptions thrown by callbacks are uncaught exceptions
+  bool isExceptionPending = false;
+  napi_is_exception_pending(env_, &isExceptionPending);
+  if (isExceptionPending) {
+    napi_value error;
+    napi_get_and_clear_last_exception(env_, &error);
+    napi_fatal_exception(env_, error);
+  }
+  napi_close_callback_scope(env_, callbackScope);
+  napi_async_destroy(env_, task.context_);
+  napi_delete_reference(env_, task.resourceRef_);
+  napi_close_handle_scope(env_, scope);
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#ifndef NAPI_VERSION
+#define NAPI_VERSION 3
+#endif
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <node_api.h>
+#include <uv.h>
+
+/**
+ * Forward declarations
+ */
+struct BaseWorker;
+
+/**
+ * Thread pool owned by a `Database`, so its workers do not compete with
+ * `fs`, `crypto` and other users of the libuv thread pool
+ *
+ * Workers run in one of two lanes, long running workers such as
+ * compactions and range clears have their own lane so they cannot starve
+ * point reads and writes
+ * Completed workers are handed back to the main thread through a
+ * `uv_async_t`, where their callbacks run in their own async context
+ */
+struct Executor final {
+  /**
+   * Starts `threads` threads for short workers and `longThreads` threads
+   * for long running workers
+   * Without `longThreads`, long running workers share the short lane
+   */
+  Executor(napi_env env, const uint32_t threads, const uint32_t longThreads);
+
+  ~Executor();
+
+  /**
+   * Queues `worker` to be executed
+   * Call this from the main thread
+   */
+  void Submit(napi_env env, BaseWorker* worker, const char* resourceName,
+              const bool longRunning);
+
+  /**
+   * Executes the remaining workers, joins the threads and completes the
+   * workers on the main thread
+   * Without `complete` the workers are not completed, this is only for
+   * environment teardown where JS can no longer be called
+   * The executor deletes itself once its handle is closed
+   * Call this from the main thread
+   */
+  void Stop(const bool complete = true);
+
+ private:
+  struct Task {
+    BaseWorker* worker_;
+    napi_async_context context_;
+    napi_ref resourceRef_;
+  };
+
+  struct Lane {
+    std::deque<Task> queue_;
+    std::condition_variable available_;
+    std::vector<std::thread> threads_;
+  };
+
+  void Run(Lane* lane);
+
+  static void OnAsync(uv_async_t* handle);
+
+  static void OnClose(uv_handle_t* handle);
+
+  /**
+   * Completes the executed workers until none are left
+   */
+  void Drain();
+
+  void Complete(Task& task);
+
+  napi_env env_;
+  uv_async_t async_;
+  std::mutex mutex_;
+  Lane shortLane_;
+  Lane longLane_;
+  std::deque<Task> completed_;
+  bool stopping_;
+  /**
+   * Only used on the main thread
+   * The handle is referenced while workers are pending, so an idle
+   * executor does not keep the process alive
+   */
+  uint32_t pending_;
+  bool draining_;
+  bool closing_;
+};
@@ -1,21 +1,31 @@
 #define NAPI_VERSION 3
 
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <map>
+#include <utility>
 #include <vector>
 
 #include <node_api.h>
 #include <napi-macros.h>
+#include <rocksdb/cache.h>
 #include <rocksdb/slice.h>
 #include <rocksdb/write_batch.h>
 #include <rocksdb/snapshot.h>
+#include <rocksdb/statistics.h>
+#include <rocksdb/table.h>
+#include <rocksdb/write_buffer_manager.h>
 
 #include "debug.h"
 #include "database.h"
+#include "executor.h"
 #include "batch.h"
 #include "iterator.h"
+#include "keypath.h"
+#include "latency.h"
 #include "transaction.h"
 #include "snapshot.h"
 #include "utils.h"
@@ -43,6 +53,8 @@ static void env_cleanup_hook(void* arg) {
   // If it hasn't been opened, it means only `dbInit` was caled
   // If it hasn't been closed, then `GCDatabase` did not yet run
   // Therefore this must also check if the `db_` is still set
+  // Executing workers must finish before the database is closed
+  database->StopExecutor(false);
   if (!database->hasClosed_ && database->db_ != nullptr) {
     std::map<uint32_t, Iterator*> iterators = database->iterators_;
     std::map<uint32_t, Iterator*>::iterator iterator_it;
@@ -156,6 +168,8 @@ static void GCDatabase(napi_env env, void* data, void* hint) {
   if (data != nullptr) {
     auto database = static_cast<Database*>(data);
     napi_remove_env_cleanup_hook(env, env_cleanup_hook, database);
+    // JS cannot be called from finalizers
+    database->StopExecutor(false);
     if (!database->isClosing_ && !database->hasClosed_) {
       database->Close();
       database->Detach(env);
@@ -248,6 +262,118 @@ static void GCTransactionSnapshot(napi_env env, void* data, void* hint) {
   LOG_DEBUG("%s:Called %s\n", __func__, __func__);
 }
 
+/**
+ * Garbage collect a cache handle
+ * Databases opened with the cache keep it alive
+ */
+static void GCCache(napi_env env, void* data, void* hint) {
+  LOG_DEBUG("%s:Calling %s\n", __func__, __func__);
+  if (data != nullptr) {
+    auto cache = static_cast<std::shared_ptr<rocksdb::Cache>*>(data);
+    delete cache;
+  }
+  LOG_DEBUG("%s:Called %s\n", __func__, __func__);
+}
+
+/**
+ * Creates a block cache that can be shared by databases
+ * Its capacity is shared by all of their column families
+ *
+ * @returns {napi_value} A `napi_external` that references the cache
+ */
+NAPI_METHOD(cacheInit) {
+  NAPI_ARGV(1);
+  napi_value options = argv[0];
+  const uint64_t size = Uint64Property(env, options, "size", 8 << 20);
+  const int shardBits = Int32Property(env, options, "shardBits", -1);
+  const bool strictCapacityLimit =
+      BooleanProperty(env, options, "strictCapacityLimit", false);
+  const std::string type = StringProperty(env, options, "type");
+  std::shared_ptr<rocksdb::Cache> cache;
+  if (type == "clock") {
+    cache = rocksdb::NewClockCache(size, shardBits, strictCapacityLimit);
+    // RocksDB only has a clock cache when it is built with TBB
+    if (!cache) {
+      napi_throw_error(env, "CACHE_UNSUPPORTED",
+                       "Clock cache is not supported by this build");
+      NAPI_RETURN_UNDEFINED();
+    }
+  } else {
+    cache = rocksdb::NewLRUCache(size, shardBits, strictCapacityLimit);
+  }
+  napi_value cache_ref;
+  NAPI_STATUS_THROWS(napi_create_external(
+      env, new std::shared_ptr<rocksdb::Cache>(std::move(cache)), GCCache,
+      nullptr, &cache_ref));
+  return cache_ref;
+}
+
+/**
+ * Garbage collect a write buffer manager handle
+ * Databases opened with the write buffer manager keep it alive
+ */
+static void GCWriteBufferManager(napi_env env, void* data, void* hint) {
+  LOG_DEBUG("%s:Calling %s\n", __func__, __func__);
+  if (data != nullptr) {
+    auto writeBufferManager =
+        static_cast<std::shared_ptr<rocksdb::WriteBufferManager>*>(data);
+    delete writeBufferManager;
+  }
+  LOG_DEBUG("%s:Called %s\n", __func__, __func__);
+}
+
+/**
+ * Creates a write buffer manager that can be shared by databases
+ * Once the memtables of all of them use more than its size, the database
+ * being written flushes a memtable
+ * With a cache, memtable memory is charged to the cache, so both share one
+ * budget
+ *
+ * @returns {napi_value} A `napi_external` that references the write buffer
+ * manager
+ */
+NAPI_METHOD(writeBufferManagerInit) {
+  NAPI_ARGV(1);
+  napi_value options = argv[0];
+  const uint64_t size = Uint64Property(env, options, "size", 64 << 20);
+  std::shared_ptr<rocksdb::Cache> cache = CacheProperty(env, options, "cache");
+  napi_value writeBufferManager_ref;
+  NAPI_STATUS_THROWS(napi_create_external(
+      env,
+      new std::shared_ptr<rocksdb::WriteBufferManager>(
+          std::make_shared<rocksdb::WriteBufferManager>(size, cache)),
+      GCWriteBufferManager, nullptr, &writeBufferManager_ref));
+  return writeBufferManager_ref;
+}
+
+/**
+ * Gets the memtable memory of a write buffer manager in bytes
+ *
+ * @returns {napi_value} An object with the `size` limit, the `usage` of all
+ * memtables and the `mutableUsage` of the memtables still being written
+ */
+NAPI_METHOD(writeBufferManagerUsage) {
+  NAPI_ARGV(1);
+  std::shared_ptr<rocksdb::WriteBufferManager>* writeBufferManager = NULL;
+  NAPI_STATUS_THROWS(
+      napi_get_value_external(env, argv[0], (void**)&writeBufferManager));
+  napi_value result;
+  NAPI_STATUS_THROWS(napi_create_object(env, &result));
+  const std::pair<const char*, size_t> fields[] = {
+      {"size", (*writeBufferManager)->buffer_size()},
+      {"usage", (*writeBufferManager)->memory_usage()},
+      {"mutableUsage", (*writeBufferManager)->mutable_memtable_memory_usage()},
+  };
+  for (const std::pair<const char*, size_t>& field : fields) {
+    napi_value value;
+    NAPI_STATUS_THROWS(
+        napi_create_double(env, static_cast<double>(field.second), &value));
+    NAPI_STATUS_THROWS(
+        napi_set_named_property(env, result, field.first, value));
+  }
+  return result;
+}
+
 /**
  * Creates the Database object
  */
@@ -263,6 +389,146 @@ NAPI_METHOD(dbInit) {
   return database_ref;
 }
 
+/**
+ * Reads a compression option, `true` is Snappy and `false` is none
+ * Returns false for unknown values
+ */
+static bool CompressionValue(napi_env env, napi_value value,
+                             rocksdb::CompressionType* compression) {
+  napi_valuetype type;
+  napi_typeof(env, value, &type);
+  if (type == napi_boolean) {
+    bool result;
+    napi_get_value_bool(env, value, &result);
+    *compression =
+        result ? rocksdb::kSnappyCompression : rocksdb::kNoCompression;
+    return true;
+  }
+  if (type != napi_string) return false;
+  size_t size = 0;
+  napi_get_value_string_utf8(env, value, NULL, 0, &size);
+  std::string name(size, '\0');
+  napi_get_value_string_utf8(env, value, &name[0], size + 1, &size);
+  if (name == "none") {
+    *compression = rocksdb::kNoCompression;
+  } else if (name == "snappy") {
+    *compression = rocksdb::kSnappyCompression;
+  } else if (name == "lz4") {
+    *compression = rocksdb::kLZ4Compression;
+  } else if (name == "lz4hc") {
+    *compression = rocksdb::kLZ4HCCompression;
+  } else if (name == "zstd") {
+    *compression = rocksdb::kZSTD;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Reads the options of the column family `name` from `options` into
+ * `config`, options that are not set are taken from `defaults`
+ * Returns the error message of an invalid option, otherwise nullptr
+ */
+static const char* ColumnFamilyConfigOption(napi_env env, napi_value options,
+                                            const std::string& name,
+                                            const ColumnFamilyConfig& defaults,
+                                            ColumnFamilyConfig& config) {
+  config.name_ = name;
+  config.compression_ = defaults.compression_;
+  if (HasProperty(env, options, "compression") &&
+      !CompressionValue(env, GetProperty(env, options, "compression"),
+                        &config.compression_)) {
+    return "Invalid compression";
+  }
+  config.compressionPerLevel_ = defaults.compressionPerLevel_;
+  if (HasProperty(env, options, "compressionPerLevel")) {
+    napi_value levels = GetProperty(env, options, "compressionPerLevel");
+    uint32_t length = 0;
+    napi_get_array_length(env, levels, &length);
+    config.compressionPerLevel_.resize(length);
+    for (uint32_t i = 0; i < length; i++) {
+      napi_value level;
+      napi_get_element(env, levels, i, &level);
+      if (!CompressionValue(env, level, &config.compressionPerLevel_[i])) {
+        return "Invalid compression";
+      }
+    }
+  }
+  config.bottommostCompression_ = defaults.bottommostCompression_;
+  if (HasProperty(env, options, "bottommostCompression") &&
+      !CompressionValue(env, GetProperty(env, options, "bottommostCompression"),
+                        &config.bottommostCompression_)) {
+    return "Invalid compression";
+  }
+  config.compressionLevel_ = Int32Property(env, options, "compressionLevel",
+                                           defaults.compressionLevel_);
+  config.compressionDictBytes_ = Uint32Property(
+      env, options, "compressionDictBytes", defaults.compressionDictBytes_);
+  config.compressionDictTrainBytes_ =
+      Uint32Property(env, options, "compressionDictTrainBytes",
+                     defaults.compressionDictTrainBytes_);
+  config.writeBufferSize_ = Uint64Property(env, options, "writeBufferSize",
+                                           defaults.writeBufferSize_);
+  config.maxWriteBufferNumber_ = Uint32Property(
+      env, options, "maxWriteBufferNumber", defaults.maxWriteBufferNumber_);
+  config.minWriteBufferNumberToMerge_ =
+      Uint32Property(env, options, "minWriteBufferNumberToMerge",
+                     defaults.minWriteBufferNumberToMerge_);
+  config.blockSize_ =
+      Uint32Property(env, options, "blockSize", defaults.blockSize_);
+  config.blockRestartInterval_ = Uint32Property(
+      env, options, "blockRestartInterval", defaults.blockRestartInterval_);
+  config.prefixLevels_ =
+      Uint32Property(env, options, "prefixLevels", defaults.prefixLevels_);
+  config.partitionedIndexFilters_ =
+      BooleanProperty(env, options, "partitionedIndexFilters",
+                      defaults.partitionedIndexFilters_);
+  config.cacheIndexAndFilterBlocks_ =
+      BooleanProperty(env, options, "cacheIndexAndFilterBlocks",
+                      defaults.cacheIndexAndFilterBlocks_);
+  config.pinL0FilterAndIndexBlocks_ =
+      BooleanProperty(env, options, "pinL0FilterAndIndexBlocks",
+                      defaults.pinL0FilterAndIndexBlocks_);
+  config.dataBlockHashIndex_ = BooleanProperty(
+      env, options, "dataBlockHashIndex", defaults.dataBlockHashIndex_);
+  config.filterBitsPerKey_ = Uint32Property(env, options, "filterBitsPerKey",
+                                            defaults.filterBitsPerKey_);
+  config.ribbonFilter_ = defaults.ribbonFilter_;
+  if (HasProperty(env, options, "filterPolicy")) {
+    const std::string filterPolicy =
+        StringProperty(env, options, "filterPolicy");
+    if (filterPolicy == "bloom") {
+      config.ribbonFilter_ = false;
+    } else if (filterPolicy == "ribbon") {
+      config.ribbonFilter_ = true;
+    } else {
+      return "Invalid filter policy";
+    }
+  }
+  config.formatVersion_ =
+      Uint32Property(env, options, "formatVersion", defaults.formatVersion_);
+  config.enableBlobFiles_ = BooleanProperty(env, options, "enableBlobFiles",
+                                            defaults.enableBlobFiles_);
+  config.minBlobSize_ =
+      Uint64Property(env, options, "minBlobSize", defaults.minBlobSize_);
+  config.blobFileSize_ =
+      Uint64Property(env, options, "blobFileSize", defaults.blobFileSize_);
+  config.blobCompression_ = defaults.blobCompression_;
+  if (HasProperty(env, options, "blobCompression") &&
+      !CompressionValue(env, GetProperty(env, options, "blobCompression"),
+                        &config.blobCompression_)) {
+    return "Invalid compression";
+  }
+  config.enableBlobGarbageCollection_ =
+      BooleanProperty(env, options, "enableBlobGarbageCollection",
+                      defaults.enableBlobGarbageCollection_);
+  config.blobGarbageCollectionAgeCutoff_ =
+      DoubleProperty(env, options, "blobGarbageCollectionAgeCutoff",
+                     defaults.blobGarbageCollectionAgeCutoff_);
+  return nullptr;
+}
+
 /**
  * Open a database
  */
@@ -270,29 +536,86 @@ NAPI_METHOD(dbOpen) {
   LOG_DEBUG("%s:Calling %s\n", __func__, __func__);
   NAPI_ARGV(4);
   NAPI_DB_CONTEXT();
+  napi_value options = argv[2];
+  napi_value callback = argv[3];
+  // Optimistic transactions validate conflicts against writes in sequence
+  // order, which unordered writes do not keep
+  if (BooleanProperty(env, options, "unorderedWrite", false)) {
+    napi_value callback_error = CreateCodeError(
+        env, "DB_OPEN", "Unordered writes are not supported by transactions");
+    NAPI_STATUS_THROWS(CallFunction(env, callback, 1, &callback_error));
+    NAPI_RETURN_UNDEFINED();
+  }
   NAPI_ARGV_UTF8_NEW(location, 1);
 
-  napi_value options = argv[2];
   const bool createIfMissing =
       BooleanProperty(env, options, "createIfMissing", true);
   const bool errorIfExists =
       BooleanProperty(env, options, "errorIfExists", false);
-  const bool compression = BooleanProperty(env, options, "compression", true);
-
   const std::string infoLogLevel = StringProperty(env, options, "infoLogLevel");
 
-  const uint32_t cacheSize = Uint32Property(env, options, "cacheSize", 8 << 20);
-  const uint32_t writeBufferSize =
-      Uint32Property(env, options, "writeBufferSize", 4 << 20);
-  const uint32_t blockSize = Uint32Property(env, options, "blockSize", 4096);
+  // A shared cache takes precedence over a cache of the database's own
+  std::shared_ptr<rocksdb::Cache> blockCache =
+      CacheProperty(env, options, "cache");
+  if (!blockCache) {
+    const uint64_t cacheSize =
+        Uint64Property(env, options, "cacheSize", 8 << 20);
+    if (cacheSize) blockCache = rocksdb::NewLRUCache(cacheSize);
+  }
+  std::shared_ptr<rocksdb::WriteBufferManager> writeBufferManager =
+      WriteBufferManagerProperty(env, options, "writeBufferManager");
   const uint32_t maxOpenFiles =
       Uint32Property(env, options, "maxOpenFiles", 1000);
-  const uint32_t blockRestartInterval =
-      Uint32Property(env, options, "blockRestartInterval", 16);
-  const uint32_t maxFileSize =
-      Uint32Property(env, options, "maxFileSize", 2 << 20);
-
-  napi_value callback = argv[3];
+  const uint64_t maxFileSize =
+      Uint64Property(env, options, "maxFileSize", 2 << 20);
+  const bool pipelinedWrite =
+      BooleanProperty(env, options, "pipelinedWrite", false);
+  const bool concurrentMemtableWrite =
+      BooleanProperty(env, options, "concurrentMemtableWrite", true);
+  const bool statistics = BooleanProperty(env, options, "statistics", false);
+  const uint32_t workerThreads =
+      Uint32Property(env, options, "workerThreads", 4);
+  const uint32_t longWorkerThreads =
+      Uint32Property(env, options, "longWorkerThreads", 1);
+
+  const ColumnFamilyConfig base;
+  ColumnFamilyConfig defaults;
+  const char* configError = ColumnFamilyConfigOption(
+      env, options, rocksdb::kDefaultColumnFamilyName, base, defaults);
+
+  // Column families default to the options of the default column family
+  std::vector<ColumnFamilyConfig> columnFamilies;
+  if (HasProperty(env, options, "columnFamilies")) {
+    napi_value columnFamiliesOptions =
+        GetProperty(env, options, "columnFamilies");
+    napi_value names;
+    NAPI_STATUS_THROWS(
+        napi_get_property_names(env, columnFamiliesOptions, &names));
+    uint32_t length;
+    NAPI_STATUS_THROWS(napi_get_array_length(env, names, &length));
+    for (uint32_t i = 0; i < length && configError == nullptr; i++) {
+      napi_value name;
+      NAPI_STATUS_THROWS(napi_get_element(env, names, i, &name));
+      size_t size = 0;
+      NAPI_STATUS_THROWS(
+          napi_get_value_string_utf8(env, name, NULL, 0, &size));
+      std::string nameString(size, '\0');
+      NAPI_STATUS_THROWS(napi_get_value_string_utf8(
+          env, name, &nameString[0], size + 1, &size));
+      napi_value columnFamilyOptions;
+      NAPI_STATUS_THROWS(napi_get_property(env, columnFamiliesOptions, name,
+                                           &columnFamilyOptions));
+      columnFamilies.emplace_back();
+      configError = ColumnFamilyConfigOption(env, columnFamilyOptions,
+                                             nameString, defaults,
+                                             columnFamilies.back());
+    }
+  }
+  if (configError != nullptr) {
+    napi_value callback_error = CreateCodeError(env, "DB_OPEN", configError);
+    NAPI_STATUS_THROWS(CallFunction(env, callback, 1, &callback_error));
+    NAPI_RETURN_UNDEFINED();
+  }
 
   rocksdb::InfoLogLevel log_level;
   rocksdb::Logger* logger;
@@ -325,8 +648,13 @@ NAPI_METHOD(dbOpen) {
 
   OpenWorker* worker = new OpenWorker(
       env, database, callback, location, createIfMissing, errorIfExists,
-      compression, writeBufferSize, blockSize, maxOpenFiles,
-      blockRestartInterval, maxFileSize, cacheSize, log_level, logger);
+      maxOpenFiles, maxFileSize, std::move(blockCache),
+      std::move(writeBufferManager), pipelinedWrite, concurrentMemtableWrite,
+      statistics, defaults, columnFamilies, log_level, logger);
+  // Reopening keeps the executor of an open that failed
+  if (workerThreads > 0 && database->executor_ == nullptr) {
+    database->executor_ = new Executor(env, workerThreads, longWorkerThreads);
+  }
   LOG_DEBUG("%s:Queuing OpenWorker\n", __func__);
   worker->Queue(env);
   delete[] location;
@@ -396,19 +724,22 @@ NAPI_METHOD(dbClose) {
 
 /**
  * Gets a value from a database.
+ * Values in the memtables or the block cache are read on the main thread
  */
 NAPI_METHOD(dbGet) {
   NAPI_ARGV(4);
   NAPI_DB_CONTEXT();
-  rocksdb::Slice key = ToSlice(env, argv[1]);
   napi_value options = argv[2];
+  NAPI_COLUMN_FAMILY_CONTEXT(options, database);
+  rocksdb::Slice key = ToSlice(env, argv[1]);
   const bool asBuffer = EncodingIsBuffer(env, options, "valueEncoding");
   const bool fillCache = BooleanProperty(env, options, "fillCache", true);
   const Snapshot* snapshot = SnapshotProperty(env, options, "snapshot");
   napi_value callback = argv[3];
-  GetWorker* worker = new GetWorker(env, database, callback, key, asBuffer,
-                                    fillCache, snapshot);
-  worker->Queue(env);
+  GetWorker* worker = new GetWorker(env, database, columnFamily, callback, key,
+                                    asBuffer, fillCache, snapshot);
+  worker->SetPerf(env, options);
+  worker->QueueFast(env);
   NAPI_RETURN_UNDEFINED();
 }
 
@@ -418,14 +749,17 @@ NAPI_METHOD(dbGet) {
 NAPI_METHOD(dbMultiGet) {
   NAPI_ARGV(4);
   NAPI_DB_CONTEXT();
-  const std::vector<rocksdb::Slice>* keys = KeyArray(env, argv[1]);
   napi_value options = argv[2];
+  NAPI_COLUMN_FAMILY_CONTEXT(options, database);
+  const std::vector<rocksdb::Slice>* keys = KeyArray(env, argv[1]);
   const bool asBuffer = EncodingIsBuffer(env, options, "valueEncoding");
   const bool fillCache = BooleanProperty(env, options, "fillCache", true);
   const Snapshot* snapshot = SnapshotProperty(env, options, "snapshot");
   napi_value callback = argv[3];
-  MultiGetWorker* worker = new MultiGetWorker(env, database, keys, callback,
-                                              asBuffer, fillCache, snapshot);
+  MultiGetWorker* worker =
+      new MultiGetWorker(env, database, columnFamily, keys, callback,
+                         asBuffer, fillCache, snapshot);
+  worker->SetPerf(env, options);
   worker->Queue(env);
   NAPI_RETURN_UNDEFINED();
 }
@@ -436,11 +770,13 @@ NAPI_METHOD(dbMultiGet) {
 NAPI_METHOD(dbPut) {
   NAPI_ARGV(5);
   NAPI_DB_CONTEXT();
+  NAPI_COLUMN_FAMILY_CONTEXT(argv[3], database);
   rocksdb::Slice key = ToSlice(env, argv[1]);
   rocksdb::Slice value = ToSlice(env, argv[2]);
   bool sync = BooleanProperty(env, argv[3], "sync", false);
   napi_value callback = argv[4];
-  PutWorker* worker = new PutWorker(env, database, callback, key, value, sync);
+  PutWorker* worker =
+      new PutWorker(env, database, columnFamily, callback, key, value, sync);
   worker->Queue(env);
   NAPI_RETURN_UNDEFINED();
 }
@@ -451,10 +787,12 @@ NAPI_METHOD(dbPut) {
 NAPI_METHOD(dbDel) {
   NAPI_ARGV(4);
   NAPI_DB_CONTEXT();
+  NAPI_COLUMN_FAMILY_CONTEXT(argv[2], database);
   rocksdb::Slice key = ToSlice(env, argv[1]);
   bool sync = BooleanProperty(env, argv[2], "sync", false);
   napi_value callback = argv[3];
-  DelWorker* worker = new DelWorker(env, database, callback, key, sync);
+  DelWorker* worker =
+      new DelWorker(env, database, columnFamily, callback, key, sync);
   worker->Queue(env);
   NAPI_RETURN_UNDEFINED();
 }
@@ -466,6 +804,7 @@ NAPI_METHOD(dbClear) {
   NAPI_ARGV(3);
   NAPI_DB_CONTEXT();
   napi_value options = argv[1];
+  NAPI_COLUMN_FAMILY_CONTEXT(options, database);
   napi_value callback = argv[2];
   const int limit = Int32Property(env, options, "limit", -1);
   std::string* lt = RangeOption(env, options, "lt");
@@ -474,8 +813,9 @@ NAPI_METHOD(dbClear) {
   std::string* gte = RangeOption(env, options, "gte");
   const Snapshot* snapshot = SnapshotProperty(env, options, "snapshot");
   const bool sync = BooleanProperty(env, options, "sync", false);
-  IteratorClearWorker* worker = new IteratorClearWorker(
-      env, database, callback, limit, lt, lte, gt, gte, sync, snapshot);
+  IteratorClearWorker* worker =
+      new IteratorClearWorker(env, database, columnFamily, callback, limit, lt,
+                              lte, gt, gte, sync, snapshot);
   worker->Queue(env);
   NAPI_RETURN_UNDEFINED();
 }
@@ -487,15 +827,19 @@ NAPI_METHOD(dbCount) {
   NAPI_ARGV(3);
   NAPI_DB_CONTEXT();
   napi_value options = argv[1];
+  NAPI_COLUMN_FAMILY_CONTEXT(options, database);
   napi_value callback = argv[2];
   const int limit = Int32Property(env, options, "limit", -1);
   std::string* lt = RangeOption(env, options, "lt");
   std::string* lte = RangeOption(env, options, "lte");
   std::string* gt = RangeOption(env, options, "gt");
   std::string* gte = RangeOption(env, options, "gte");
+  const bool estimate = BooleanProperty(env, options, "estimate", false);
   const Snapshot* snapshot = SnapshotProperty(env, options, "snapshot");
-  IteratorCountWorker* worker = new IteratorCountWorker(
-      env, database, callback, limit, lt, lte, gt, gte, snapshot);
+  IteratorCountWorker* worker =
+      new IteratorCountWorker(env, database, columnFamily, callback, limit, lt,
+                              lte, gt, gte, estimate, snapshot);
+  worker->SetPerf(env, options);
   worker->Queue(env);
   NAPI_RETURN_UNDEFINED();
 }
@@ -545,6 +889,129 @@ NAPI_METHOD(dbGetProperty) {
   return result;
 }
 
+/**
+ * Creates an object of the summary of a histogram
+ */
+static napi_value HistogramObject(napi_env env,
+                                  const rocksdb::HistogramData& data) {
+  napi_value object;
+  napi_create_object(env, &object);
+  const std::pair<const char*, double> fields[] = {
+      {"count", static_cast<double>(data.count)},
+      {"sum", static_cast<double>(data.sum)},
+      {"min", data.min},
+      {"max", data.max},
+      {"average", data.average},
+      {"standardDeviation", data.standard_deviation},
+      {"median", data.median},
+      {"percentile95", data.percentile95},
+      {"percentile99", data.percentile99},
+  };
+  for (const std::pair<const char*, double>& field : fields) {
+    napi_value value;
+    napi_create_double(env, field.second, &value);
+    napi_set_named_property(env, object, field.first, value);
+  }
+  return object;
+}
+
+/**
+ * Gets the statistics of a database
+ * Tickers and histograms are keyed by their RocksDB names, such as
+ * `rocksdb.block.cache.hit` and `rocksdb.db.get.micros`
+ *
+ * @returns {napi_value} An object of `tickers` and `histograms`, or
+ * `undefined` if the database was not opened with `statistics`
+ */
+NAPI_METHOD(dbGetStatistics) {
+  NAPI_ARGV(1);
+  NAPI_DB_CONTEXT();
+  if (!database->statistics_) NAPI_RETURN_UNDEFINED();
+  const std::shared_ptr<rocksdb::Statistics>& statistics =
+      database->statistics_;
+  napi_value tickers;
+  NAPI_STATUS_THROWS(napi_create_object(env, &tickers));
+  for (const std::pair<rocksdb::Tickers, std::string>& ticker :
+       rocksdb::TickersNameMap) {
+    napi_value count;
+    NAPI_STATUS_THROWS(napi_create_double(
+        env, static_cast<double>(statistics->getTickerCount(ticker.first)),
+        &count));
+    NAPI_STATUS_THROWS(
+        napi_set_named_property(env, tickers, ticker.second.c_str(), count));
+  }
+  napi_value histograms;
+  NAPI_STATUS_THROWS(napi_create_object(env, &histograms));
+  for (const std::pair<rocksdb::Histograms, std::string>& histogram :
+       rocksdb::HistogramsNameMap) {
+    rocksdb::HistogramData data;
+    statistics->histogramData(histogram.first, &data);
+    NAPI_STATUS_THROWS(
+        napi_set_named_property(env, histograms, histogram.second.c_str(),
+                                HistogramObject(env, data)));
+  }
+  napi_value result;
+  NAPI_STATUS_THROWS(napi_create_object(env, &result));
+  NAPI_STATUS_THROWS(
+      napi_set_named_property(env, result, "tickers", tickers));
+  NAPI_STATUS_THROWS(
+      napi_set_named_property(env, result, "histograms", histograms));
+  return result;
+}
+
+/**
+ * Resets the statistics of a database
+ * This is a noop if the database was not opened with `statistics`
+ */
+NAPI_METHOD(dbResetStatistics) {
+  NAPI_ARGV(1);
+  NAPI_DB_CONTEXT();
+  if (database->statistics_) database->statistics_->Reset();
+  NAPI_RETURN_UNDEFINED();
+}
+
+/**
+ * Gets a column family of a database by name
+ *
+ * @returns {napi_value} A `napi_external` that references `ColumnFamily`, or
+ * `undefined` if the column family doesn't exist
+ */
+NAPI_METHOD(dbColumnFamily) {
+  NAPI_ARGV(2);
+  NAPI_DB_CONTEXT();
+  NAPI_ARGV_UTF8_NEW(name, 1);
+  std::map<std::string, ColumnFamily*>::iterator it =
+      database->columnFamilies_.find(name);
+  delete[] name;
+  if (it == database->columnFamilies_.end()) NAPI_RETURN_UNDEFINED();
+  // The `Database` owns the column family, so there is no finalizer
+  napi_value columnFamily_ref;
+  NAPI_STATUS_THROWS(napi_create_external(env, it->second, nullptr, nullptr,
+                                          &columnFamily_ref));
+  return columnFamily_ref;
+}
+
+/**
+ * Drops a column family from a database, deleting all of its data
+ */
+NAPI_METHOD(dbDropColumnFamily) {
+  NAPI_ARGV(3);
+  NAPI_DB_CONTEXT();
+  ColumnFamily* columnFamily = NULL;
+  NAPI_STATUS_THROWS(
+      napi_get_value_external(env, argv[1], (void**)&columnFamily));
+  if (!database->OwnsColumnFamily(columnFamily)) {
+    napi_throw_error(env, "COLUMN_FAMILY_INVALID",
+                     "Column family does not belong to the database");
+    NAPI_RETURN_UNDEFINED();
+  }
+  napi_value callback = argv[2];
+  DropColumnFamilyWorker* worker =
+      new DropColumnFamilyWorker(env, database, columnFamily, callback);
+  worker->Queue(env);
+  NAPI_RETURN_UNDEFINED();
+}
+
 /**
  * Gets a snapshot from the database
  */
@@ -605,6 +1072,66 @@ NAPI_METHOD(repairDb) {
   NAPI_RETURN_UNDEFINED();
 }
 
+/**
+ * Creates an object of a latency histogram
+ */
+static napi_value LatencyHistogramObject(napi_env env,
+                                         const LatencyHistogram& histogram) {
+  napi_value object;
+  napi_create_object(env, &object);
+  const std::pair<const char*, uint64_t> fields[] = {
+      {"count", histogram.count_.load(std::memory_order_relaxed)},
+      {"sum", histogram.sum_.load(std::memory_order_relaxed)},
+      {"max", histogram.max_.load(std::memory_order_relaxed)},
+  };
+  for (const std::pair<const char*, uint64_t>& field : fields) {
+    napi_value value;
+    napi_create_double(env, static_cast<double>(field.second), &value);
+    napi_set_named_property(env, object, field.first, value);
+  }
+  napi_value buckets;
+  napi_create_array_with_length(env, LatencyHistogram::kBuckets, &buckets);
+  for (size_t i = 0; i < LatencyHistogram::kBuckets; i++) {
+    napi_value value;
+    napi_create_double(
+        env,
+        static_cast<double>(
+            histogram.buckets_[i].load(std::memory_order_relaxed)),
+        &value);
+    napi_set_element(env, buckets, static_cast<uint32_t>(i), value);
+  }
+  napi_set_named_property(env, object, "buckets", buckets);
+  return object;
+}
+
+/**
+ * Gets the latencies of the workers of every resource name, such as
+ * `rocksdb.db.get`, across all databases of the process
+ * Each has the histograms of its `queue` wait, its `execute` time on a pool
+ * thread and its `complete` time on the main thread, in microseconds
+ */
+NAPI_METHOD(workerLatencies) {
+  napi_value result;
+  NAPI_STATUS_THROWS(napi_create_object(env, &result));
+  for (const std::pair<const std::string, WorkerLatency*>& entry :
+       GetWorkerLatencies()) {
+    napi_value latency;
+    NAPI_STATUS_THROWS(napi_create_object(env, &latency));
+    NAPI_STATUS_THROWS(napi_set_named_property(
+        env, latency, "queue",
+        LatencyHistogramObject(env, entry.second->queue_)));
+    NAPI_STATUS_THROWS(napi_set_named_property(
+        env, latency, "execute",
+        LatencyHistogramObject(env, entry.second->execute_)));
+    NAPI_STATUS_THROWS(napi_set_named_property(
+        env, latency, "complete",
+        LatencyHistogramObject(env, entry.second->complete_)));
+    NAPI_STATUS_THROWS(
+        napi_set_named_property(env, result, entry.first.c_str(), latency));
+  }
+  return result;
+}
+
 /**
  * Create an iterator.
  */
@@ -613,6 +1140,7 @@ NAPI_METHOD(iteratorInit) {
   NAPI_ARGV(2);
   NAPI_DB_CONTEXT();
   napi_value options = argv[1];
+  NAPI_COLUMN_FAMILY_CONTEXT(options, database);
   const bool reverse = BooleanProperty(env, options, "reverse", false);
   const bool keys = BooleanProperty(env, options, "keys", true);
   const bool values = BooleanProperty(env, options, "values", true);
@@ -622,6 +1150,8 @@ NAPI_METHOD(iteratorInit) {
   const int limit = Int32Property(env, options, "limit", -1);
   const uint32_t highWaterMarkBytes =
       Uint32Property(env, options, "highWaterMarkBytes", 16 * 1024);
+  const bool keyPath = BooleanProperty(env, options, "keyPath", false);
+  const bool prefetch = BooleanProperty(env, options, "prefetch", false);
   std::string* lt = RangeOption(env, options, "lt");
   std::string* lte = RangeOption(env, options, "lte");
   std::string* gt = RangeOption(env, options, "gt");
@@ -629,8 +1159,9 @@ NAPI_METHOD(iteratorInit) {
   const Snapshot* snapshot = SnapshotProperty(env, options, "snapshot");
   const uint32_t id = database->currentIteratorId_++;
   Iterator* iterator = new Iterator(
-      database, id, reverse, keys, values, limit, lt, lte, gt, gte, fillCache,
-      keyAsBuffer, valueAsBuffer, highWaterMarkBytes, snapshot);
+      database, columnFamily, id, reverse, keys, values, limit, lt, lte, gt,
+      gte, fillCache, keyAsBuffer, valueAsBuffer, highWaterMarkBytes, keyPath,
+      prefetch, snapshot);
   napi_value iterator_ref;
   NAPI_STATUS_THROWS(
       napi_create_external(env, iterator, GCIterator, NULL, &iterator_ref));
@@ -649,8 +1180,20 @@ NAPI_METHOD(iteratorSeek) {
     NAPI_RETURN_UNDEFINED();
   }
   rocksdb::Slice target = ToSlice(env, argv[1]);
-  iterator->first_ = true;
-  iterator->Seek(target);
+  if (iterator->prefetching_) {
+    // The prefetch is still using the iterator
+    iterator->seekPending_ = true;
+    iterator->seekTarget_.assign(target.data(), target.size());
+  } else {
+    // Any prefetched batch or error is from before the seek
+    iterator->prefetched_ = false;
+    iterator->prefetchMore_ = false;
+    iterator->prefetchStatus_ = rocksdb::Status::OK();
+    iterator->packedData_.clear();
+    iterator->packedOffsets_.clear();
+    iterator->first_ = true;
+    iterator->Seek(target);
+  }
   DisposeSliceBuffer(target);
   NAPI_RETURN_UNDEFINED();
 }
@@ -678,6 +1221,38 @@ NAPI_METHOD(iteratorClose) {
  * Advance repeatedly and get multiple entries at once.
  */
 NAPI_METHOD(iteratorNextv) {
+  NAPI_ARGV(4);
+  NAPI_ITERATOR_CONTEXT();
+  uint32_t size;
+  NAPI_STATUS_THROWS(napi_get_value_uint32(env, argv[1], &size));
+  if (size == 0) size = 1;
+  napi_value options = argc > 3 ? argv[2] : nullptr;
+  napi_value callback = argc > 3 ? argv[3] : argv[2];
+  if (iterator->isClosing_ || iterator->hasClosed_) {
+    napi_value argv =
+        CreateCodeError(env, "ITERATOR_NOT_OPEN", "Iterator is not open");
+    NAPI_STATUS_THROWS(CallFunction(env, callback, 1, &argv));
+    NAPI_RETURN_UNDEFINED();
+  }
+  if (iterator->prefetch_) {
+    napi_value argv = CreateCodeError(
+        env, "ITERATOR_PREFETCH",
+        "Prefetching iterators only support packed batches");
+    NAPI_STATUS_THROWS(CallFunction(env, callback, 1, &argv));
+    NAPI_RETURN_UNDEFINED();
+  }
+  IteratorNextWorker* worker =
+      new IteratorNextWorker(env, iterator, size, callback);
+  if (options != nullptr) worker->SetPerf(env, options);
+  iterator->nexting_ = true;
+  worker->Queue(env);
+  NAPI_RETURN_UNDEFINED();
+}
+
+/**
+ * Advance repeatedly and get multiple entries at once as one packed buffer.
+ */
+NAPI_METHOD(iteratorNextvPacked) {
   NAPI_ARGV(3);
   NAPI_ITERATOR_CONTEXT();
   uint32_t size;
@@ -690,8 +1265,30 @@ NAPI_METHOD(iteratorNextv) {
     NAPI_STATUS_THROWS(CallFunction(env, callback, 1, &argv));
     NAPI_RETURN_UNDEFINED();
   }
+  if (iterator->prefetched_) {
+    iterator->AdaptPrefetchSize(size, false);
+    IteratorPrefetchWorker::Deliver(env, iterator, callback);
+    NAPI_RETURN_UNDEFINED();
+  }
+  if (iterator->prefetching_) {
+    if (iterator->prefetchCallback_ != nullptr) {
+      // Only one batch request can wait for the prefetch
+      napi_value argv = CreateCodeError(
+          env, "ITERATOR_BUSY", "Iterator is already waiting for a batch");
+      NAPI_STATUS_THROWS(CallFunction(env, callback, 1, &argv));
+      NAPI_RETURN_UNDEFINED();
+    }
+    // Delivered as soon as the prefetch finishes
+    iterator->AdaptPrefetchSize(size, true);
+    NAPI_STATUS_THROWS(
+        napi_create_reference(env, callback, 1, &iterator->prefetchCallback_));
+    NAPI_RETURN_UNDEFINED();
+  }
+  if (iterator->prefetch_) {
+    iterator->prefetchSize_ = std::min(iterator->prefetchSize_, size);
+  }
   IteratorNextWorker* worker =
-      new IteratorNextWorker(env, iterator, size, callback);
+      new IteratorNextWorker(env, iterator, size, callback, true);
   iterator->nexting_ = true;
   worker->Queue(env);
   NAPI_RETURN_UNDEFINED();
@@ -715,10 +1312,16 @@ NAPI_METHOD(batchDo) {
     napi_get_element(env, array, i, &element);
     if (!IsObject(env, element)) continue;
     std::string type = StringProperty(env, element, "type");
+    ColumnFamily* columnFamily =
+        ColumnFamilyProperty(env, element, "columnFamily", database);
+    if (columnFamily == nullptr) {
+      delete batch;
+      NAPI_RETURN_UNDEFINED();
+    }
     if (type == "del") {
       if (!HasProperty(env, element, "key")) continue;
       rocksdb::Slice key = ToSlice(env, GetProperty(env, element, "key"));
-      batch->Delete(key);
+      batch->Delete(columnFamily->handle_, key);
       if (!hasData) hasData = true;
       DisposeSliceBuffer(key);
     } else if (type == "put") {
@@ -726,7 +1329,7 @@ NAPI_METHOD(batchDo) {
       if (!HasProperty(env, element, "value")) continue;
       rocksdb::Slice key = ToSlice(env, GetProperty(env, element, "key"));
       rocksdb::Slice value = ToSlice(env, GetProperty(env, element, "value"));
-      batch->Put(key, value);
+      batch->Put(columnFamily->handle_, key, value);
       if (!hasData) hasData = true;
       DisposeSliceBuffer(key);
       DisposeSliceBuffer(value);
@@ -756,11 +1359,12 @@ NAPI_METHOD(batchInit) {
  * Adds a put instruction to a batch object.
  */
 NAPI_METHOD(batchPut) {
-  NAPI_ARGV(3);
+  NAPI_ARGV(4);
   NAPI_BATCH_CONTEXT();
+  NAPI_COLUMN_FAMILY_CONTEXT(argv[3], batch->database_);
   rocksdb::Slice key = ToSlice(env, argv[1]);
   rocksdb::Slice value = ToSlice(env, argv[2]);
-  batch->Put(key, value);
+  batch->Put(columnFamily->handle_, key, value);
   DisposeSliceBuffer(key);
   DisposeSliceBuffer(value);
   NAPI_RETURN_UNDEFINED();
@@ -770,10 +1374,11 @@ NAPI_METHOD(batchPut) {
  * Adds a delete instruction to a batch object.
  */
 NAPI_METHOD(batchDel) {
-  NAPI_ARGV(2);
+  NAPI_ARGV(3);
   NAPI_BATCH_CONTEXT();
+  NAPI_COLUMN_FAMILY_CONTEXT(argv[2], batch->database_);
   rocksdb::Slice key = ToSlice(env, argv[1]);
-  batch->Del(key);
+  batch->Del(columnFamily->handle_, key);
   DisposeSliceBuffer(key);
   NAPI_RETURN_UNDEFINED();
 }
@@ -901,21 +1506,25 @@ NAPI_METHOD(transactionRollback) {
 
 /**
  * Gets a value from a transaction
+ * Values in the memtables or the block cache are read on the main thread
  */
 NAPI_METHOD(transactionGet) {
   NAPI_ARGV(4);
   NAPI_TRANSACTION_CONTEXT();
-  rocksdb::Slice key = ToSlice(env, argv[1]);
   napi_value options = argv[2];
+  NAPI_COLUMN_FAMILY_CONTEXT(options, transaction->database_);
+  rocksdb::Slice key = ToSlice(env, argv[1]);
   const bool asBuffer = EncodingIsBuffer(env, options, "valueEncoding");
   const bool fillCache = BooleanProperty(env, options, "fillCache", true);
   const TransactionSnapshot* snapshot =
       TransactionSnapshotProperty(env, options, "snapshot");
   napi_value callback = argv[3];
   ASSERT_TRANSACTION_READY_CB(env, transaction, callback);
-  TransactionGetWorker* worker = new TransactionGetWorker(
-      env, transaction, callback, key, asBuffer, fillCache, snapshot);
-  worker->Queue(env);
+  TransactionGetWorker* worker =
+      new TransactionGetWorker(env, transaction, columnFamily, callback, key,
+                               asBuffer, fillCache, snapshot);
+  worker->SetPerf(env, options);
+  worker->QueueFast(env);
   NAPI_RETURN_UNDEFINED();
 }
 
@@ -925,16 +1534,20 @@ NAPI_METHOD(transactionGet) {
 NAPI_METHOD(transactionGetForUpdate) {
   NAPI_ARGV(4);
   NAPI_TRANSACTION_CONTEXT();
-  rocksdb::Slice key = ToSlice(env, argv[1]);
   napi_value options = argv[2];
+  NAPI_COLUMN_FAMILY_CONTEXT(options, transaction->database_);
+  rocksdb::Slice key = ToSlice(env, argv[1]);
   const bool asBuffer = EncodingIsBuffer(env, options, "valueEncoding");
   const bool fillCache = BooleanProperty(env, options, "fillCache", true);
   const TransactionSnapshot* snapshot =
       TransactionSnapshotProperty(env, options, "snapshot");
   napi_value callback = argv[3];
   ASSERT_TRANSACTION_READY_CB(env, transaction, callback);
-  TransactionGetForUpdateWorker* worker = new TransactionGetForUpdateWorker(
-      env, transaction, callback, key, asBuffer, fillCache, snapshot);
+  TransactionGetForUpdateWorker* worker =
+      new TransactionGetForUpdateWorker(env, transaction, columnFamily,
+                                        callback, key, asBuffer, fillCache,
+                                        snapshot);
+  worker->SetPerf(env, options);
   worker->Queue(env);
   NAPI_RETURN_UNDEFINED();
 }
@@ -945,15 +1558,18 @@ NAPI_METHOD(transactionGetForUpdate) {
 NAPI_METHOD(transactionMultiGet) {
   NAPI_ARGV(4);
   NAPI_TRANSACTION_CONTEXT();
-  const std::vector<rocksdb::Slice>* keys = KeyArray(env, argv[1]);
   napi_value options = argv[2];
+  NAPI_COLUMN_FAMILY_CONTEXT(options, transaction->database_);
+  const std::vector<rocksdb::Slice>* keys = KeyArray(env, argv[1]);
   const bool asBuffer = EncodingIsBuffer(env, options, "valueEncoding");
   const bool fillCache = BooleanProperty(env, options, "fillCache", true);
   const TransactionSnapshot* snapshot =
       TransactionSnapshotProperty(env, options, "snapshot");
   napi_value callback = argv[3];
-  TransactionMultiGetWorker* worker = new TransactionMultiGetWorker(
-      env, transaction, keys, callback, asBuffer, fillCache, snapshot);
+  TransactionMultiGetWorker* worker =
+      new TransactionMultiGetWorker(env, transaction, columnFamily, keys,
+                                    callback, asBuffer, fillCache, snapshot);
+  worker->SetPerf(env, options);
   worker->Queue(env);
   NAPI_RETURN_UNDEFINED();
 }
@@ -964,47 +1580,56 @@ NAPI_METHOD(transactionMultiGet) {
 NAPI_METHOD(transactionMultiGetForUpdate) {
   NAPI_ARGV(4);
   NAPI_TRANSACTION_CONTEXT();
-  const std::vector<rocksdb::Slice>* keys = KeyArray(env, argv[1]);
   napi_value options = argv[2];
+  NAPI_COLUMN_FAMILY_CONTEXT(options, transaction->database_);
+  const std::vector<rocksdb::Slice>* keys = KeyArray(env, argv[1]);
   const bool asBuffer = EncodingIsBuffer(env, options, "valueEncoding");
   const bool fillCache = BooleanProperty(env, options, "fillCache", true);
   const TransactionSnapshot* snapshot =
       TransactionSnapshotProperty(env, options, "snapshot");
   napi_value callback = argv[3];
   TransactionMultiGetForUpdateWorker* worker =
-      new TransactionMultiGetForUpdateWorker(env, transaction, keys, callback,
-                                             asBuffer, fillCache, snapshot);
+      new TransactionMultiGetForUpdateWorker(env, transaction, columnFamily,
+                                             keys, callback, asBuffer,
+                                             fillCache, snapshot);
+  worker->SetPerf(env, options);
   worker->Queue(env);
   NAPI_RETURN_UNDEFINED();
 }
 
 /**
  * Puts a key and a value to a transaction
+ * The options are optional, the callback is always the last argument
  */
 NAPI_METHOD(transactionPut) {
-  NAPI_ARGV(4);
+  NAPI_ARGV(5);
   NAPI_TRANSACTION_CONTEXT();
+  napi_value options = argc > 4 ? argv[3] : nullptr;
+  NAPI_COLUMN_FAMILY_CONTEXT(options, transaction->database_);
   rocksdb::Slice key = ToSlice(env, argv[1]);
   rocksdb::Slice value = ToSlice(env, argv[2]);
-  napi_value callback = argv[3];
+  napi_value callback = argc > 4 ? argv[4] : argv[3];
   ASSERT_TRANSACTION_READY_CB(env, transaction, callback);
-  TransactionPutWorker* worker =
-      new TransactionPutWorker(env, transaction, callback, key, value);
+  TransactionPutWorker* worker = new TransactionPutWorker(
+      env, transaction, columnFamily, callback, key, value);
   worker->Queue(env);
   NAPI_RETURN_UNDEFINED();
 }
 
 /**
  * Delete a value from a database.
+ * The options are optional, the callback is always the last argument
  */
 NAPI_METHOD(transactionDel) {
-  NAPI_ARGV(3);
+  NAPI_ARGV(4);
   NAPI_TRANSACTION_CONTEXT();
+  napi_value options = argc > 3 ? argv[2] : nullptr;
+  NAPI_COLUMN_FAMILY_CONTEXT(options, transaction->database_);
   rocksdb::Slice key = ToSlice(env, argv[1]);
-  napi_value callback = argv[2];
+  napi_value callback = argc > 3 ? argv[3] : argv[2];
   ASSERT_TRANSACTION_READY_CB(env, transaction, callback);
-  TransactionDelWorker* worker =
-      new TransactionDelWorker(env, transaction, callback, key);
+  TransactionDelWorker* worker = new TransactionDelWorker(
+      env, transaction, columnFamily, callback, key);
   worker->Queue(env);
   NAPI_RETURN_UNDEFINED();
 }
@@ -1027,6 +1652,7 @@ NAPI_METHOD(transactionIteratorInit) {
   NAPI_TRANSACTION_CONTEXT();
   ASSERT_TRANSACTION_READY(env, transaction);
   napi_value options = argv[1];
+  NAPI_COLUMN_FAMILY_CONTEXT(options, transaction->database_);
   const bool reverse = BooleanProperty(env, options, "reverse", false);
   const bool keys = BooleanProperty(env, options, "keys", true);
   const bool values = BooleanProperty(env, options, "values", true);
@@ -1036,6 +1662,11 @@ NAPI_METHOD(transactionIteratorInit) {
   const int limit = Int32Property(env, options, "limit", -1);
   const uint32_t highWaterMarkBytes =
       Uint32Property(env, options, "highWaterMarkBytes", 16 * 1024);
+  const bool keyPath = BooleanProperty(env, options, "keyPath", false);
+  // Prefetches would read the transaction's write batch on a worker thread
+  // while transaction writes change it, so transaction iterators never
+  // prefetch
+  const bool prefetch = false;
   std::string* lt = RangeOption(env, options, "lt");
   std::string* lte = RangeOption(env, options, "lte");
   std::string* gt = RangeOption(env, options, "gt");
@@ -1044,8 +1675,9 @@ NAPI_METHOD(transactionIteratorInit) {
       TransactionSnapshotProperty(env, options, "snapshot");
   const uint32_t id = transaction->currentIteratorId_++;
   Iterator* iterator = new Iterator(
-      transaction, id, reverse, keys, values, limit, lt, lte, gt, gte,
-      fillCache, keyAsBuffer, valueAsBuffer, highWaterMarkBytes, snapshot);
+      transaction, columnFamily, id, reverse, keys, values, limit, lt, lte, gt,
+      gte, fillCache, keyAsBuffer, valueAsBuffer, highWaterMarkBytes, keyPath,
+      prefetch, snapshot);
   napi_value iterator_ref;
   NAPI_STATUS_THROWS(
       napi_create_external(env, iterator, GCIterator, NULL, &iterator_ref));
@@ -1059,6 +1691,7 @@ NAPI_METHOD(transactionClear) {
   NAPI_TRANSACTION_CONTEXT();
   ASSERT_TRANSACTION_READY(env, transaction);
   napi_value options = argv[1];
+  NAPI_COLUMN_FAMILY_CONTEXT(options, transaction->database_);
   napi_value callback = argv[2];
   const int limit = Int32Property(env, options, "limit", -1);
   std::string* lt = RangeOption(env, options, "lt");
@@ -1067,8 +1700,9 @@ NAPI_METHOD(transactionClear) {
   std::string* gte = RangeOption(env, options, "gte");
   const TransactionSnapshot* snapshot =
       TransactionSnapshotProperty(env, options, "snapshot");
-  IteratorClearWorker* worker = new IteratorClearWorker(
-      env, transaction, callback, limit, lt, lte, gt, gte, snapshot);
+  IteratorClearWorker* worker =
+      new IteratorClearWorker(env, transaction, columnFamily, callback, limit,
+                              lt, lte, gt, gte, snapshot);
   worker->Queue(env);
   NAPI_RETURN_UNDEFINED();
 }
@@ -1078,6 +1712,7 @@ NAPI_METHOD(transactionCount) {
   NAPI_TRANSACTION_CONTEXT();
   ASSERT_TRANSACTION_READY(env, transaction);
   napi_value options = argv[1];
+  NAPI_COLUMN_FAMILY_CONTEXT(options, transaction->database_);
   napi_value callback = argv[2];
   const int limit = Int32Property(env, options, "limit", -1);
   std::string* lt = RangeOption(env, options, "lt");
@@ -1086,12 +1721,128 @@ NAPI_METHOD(transactionCount) {
   std::string* gte = RangeOption(env, options, "gte");
   const TransactionSnapshot* snapshot =
       TransactionSnapshotProperty(env, options, "snapshot");
-  IteratorCountWorker* worker = new IteratorCountWorker(
-      env, transaction, callback, limit, lt, lte, gt, gte, snapshot);
+  IteratorCountWorker* worker =
+      new IteratorCountWorker(env, transaction, columnFamily, callback, limit,
+                              lt, lte, gt, gte, snapshot);
+  worker->SetPerf(env, options);
   worker->Queue(env);
   NAPI_RETURN_UNDEFINED();
 }
 
+/**
+ * Reads the parts of a KeyPath or LevelPath array
+ * Buffers are referenced in place, strings are copied into `strings`
+ */
+static napi_status PathParts(napi_env env, napi_value array,
+                             std::vector<rocksdb::Slice>& parts,
+                             std::vector<std::string>& strings) {
+  uint32_t length;
+  napi_status status = napi_get_array_length(env, array, &length);
+  if (status != napi_ok) return status;
+  parts.reserve(length);
+  // Slices point into the strings so they must not be reallocated
+  strings.reserve(length);
+  for (uint32_t i = 0; i < length; i++) {
+    napi_value element;
+    status = napi_get_element(env, array, i, &element);
+    if (status != napi_ok) return status;
+    if (IsString(env, element)) {
+      size_t size;
+      status = napi_get_value_string_utf8(env, element, NULL, 0, &size);
+      if (status != napi_ok) return status;
+      strings.emplace_back(size, '\0');
+      std::string& string = strings.back();
+      status = napi_get_value_string_utf8(env, element, &string[0], size + 1,
+                                          &size);
+      if (status != napi_ok) return status;
+      parts.emplace_back(string);
+    } else {
+      char* data;
+      size_t size;
+      status = napi_get_buffer_info(env, element, (void**)&data, &size);
+      if (status != napi_ok) return status;
+      parts.emplace_back(data, size);
+    }
+  }
+  return napi_ok;
+}
+
+/**
+ * Encodes `levels` followed by the key actual part `key` into a new buffer
+ */
+static napi_value PathToKey(napi_env env, const rocksdb::Slice* levels,
+                            size_t count, const rocksdb::Slice* key) {
+  size_t size = 0;
+  for (size_t i = 0; i < count; i++) {
+    size += 2 + EncodedPartSize(levels[i].size());
+  }
+  if (key != nullptr) size += EncodedPartSize(key->size());
+  char* data;
+  napi_value result;
+  NAPI_STATUS_THROWS(
+      napi_create_buffer(env, size, reinterpret_cast<void**>(&data), &result));
+  for (size_t i = 0; i < count; i++) {
+    *data++ = 0x00;
+    data = EncodePart(levels[i], data);
+    *data++ = 0x00;
+  }
+  if (key != nullptr) EncodePart(*key, data);
+  return result;
+}
+
+/**
+ * Converts KeyPath to key buffer.
+ */
+NAPI_METHOD(keyPathToKey) {
+  NAPI_ARGV(1);
+  std::vector<rocksdb::Slice> parts;
+  std::vector<std::string> strings;
+  NAPI_STATUS_THROWS(PathParts(env, argv[0], parts, strings));
+  // An empty key path is converted to `['']`
+  if (parts.empty()) parts.emplace_back();
+  return PathToKey(env, parts.data(), parts.size() - 1, &parts.back());
+}
+
+/**
+ * Converts LevelPath to key buffer.
+ */
+NAPI_METHOD(levelPathToKey) {
+  NAPI_ARGV(1);
+  std::vector<rocksdb::Slice> parts;
+  std::vector<std::string> strings;
+  NAPI_STATUS_THROWS(PathParts(env, argv[0], parts, strings));
+  return PathToKey(env, parts.data(), parts.size(), nullptr);
+}
+
+/**
+ * Converts key buffer back into KeyPath.
+ */
+NAPI_METHOD(parseKey) {
+  NAPI_ARGV(1);
+  char* data;
+  size_t size;
+  NAPI_STATUS_THROWS(
+      napi_get_buffer_info(env, argv[0], (void**)&data, &size));
+  std::vector<rocksdb::Slice> parts;
+  SplitKey(rocksdb::Slice(data, size), parts);
+  napi_value result;
+  NAPI_STATUS_THROWS(napi_create_array_with_length(env, parts.size(), &result));
+  for (size_t i = 0; i < parts.size(); i++) {
+    char* partData;
+    napi_value part;
+    NAPI_STATUS_THROWS(napi_create_buffer(env, DecodedPartSize(parts[i]),
+                                          reinterpret_cast<void**>(&partData),
+                                          &part));
+    if (!DecodePart(parts[i], partData)) {
+      napi_throw(env, CreateSyntaxError(env, "Non-Base128 character"));
+      return NULL;
+    }
+    NAPI_STATUS_THROWS(
+        napi_set_element(env, result, static_cast<uint32_t>(i), part));
+  }
+  return result;
+}
+
 /**
  * All exported functions.
  */
@@ -1099,6 +1850,10 @@ NAPI_INIT() {
   // Check `NODE_DEBUG_NATIVE` environment variable
   CheckNodeDebugNative();
 
+  NAPI_EXPORT_FUNCTION(cacheInit);
+  NAPI_EXPORT_FUNCTION(writeBufferManagerInit);
+  NAPI_EXPORT_FUNCTION(writeBufferManagerUsage);
+
   NAPI_EXPORT_FUNCTION(dbInit);
   NAPI_EXPORT_FUNCTION(dbOpen);
   NAPI_EXPORT_FUNCTION(dbClose);
@@ -1111,16 +1866,22 @@ NAPI_INIT() {
   NAPI_EXPORT_FUNCTION(dbApproximateSize);
   NAPI_EXPORT_FUNCTION(dbCompactRange);
   NAPI_EXPORT_FUNCTION(dbGetProperty);
+  NAPI_EXPORT_FUNCTION(dbGetStatistics);
+  NAPI_EXPORT_FUNCTION(dbResetStatistics);
+  NAPI_EXPORT_FUNCTION(dbColumnFamily);
+  NAPI_EXPORT_FUNCTION(dbDropColumnFamily);
 
   NAPI_EXPORT_FUNCTION(snapshotInit);
   NAPI_EXPORT_FUNCTION(snapshotRelease);
 
   NAPI_EXPORT_FUNCTION(destroyDb);
   NAPI_EXPORT_FUNCTION(repairDb);
+  NAPI_EXPORT_FUNCTION(workerLatencies);
 
   NAPI_EXPORT_FUNCTION(iteratorInit);
   NAPI_EXPORT_FUNCTION(iteratorSeek);
   NAPI_EXPORT_FUNCTION(iteratorNextv);
+  NAPI_EXPORT_FUNCTION(iteratorNextvPacked);
   NAPI_EXPORT_FUNCTION(iteratorClose);
 
   NAPI_EXPORT_FUNCTION(batchDo);
@@ -1144,4 +1905,8 @@ NAPI_INIT() {
   NAPI_EXPORT_FUNCTION(transactionIteratorInit);
   NAPI_EXPORT_FUNCTION(transactionClear);
   NAPI_EXPORT_FUNCTION(transactionCount);
+
+  NAPI_EXPORT_FUNCTION(keyPathToKey);
+  NAPI_EXPORT_FUNCTION(levelPathToKey);
+  NAPI_EXPORT_FUNCTION(parseKey);
 }
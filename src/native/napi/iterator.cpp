@@ -2,10 +2,13 @@
 
 #include "iterator.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <string>
+#include <utility>
 
 #include <napi-macros.h>
 #include <node_api.h>
@@ -14,10 +17,47 @@
 #include <rocksdb/slice.h>
 
 #include "debug.h"
+#include "keypath.h"
 #include "database.h"
 #include "transaction.h"
 #include "snapshot.h"
 
+/**
+ * Values at least this large are handed to JS as external buffers
+ * Below this the finalizer costs more than copying
+ */
+static const size_t kExternalBufferMinSize = 4 * 1024;
+
+/**
+ * Prefetches shrink no smaller than this while the consumer keeps up
+ */
+static const uint32_t kPrefetchMinSize = 16;
+
+/**
+ * Finalizer for external buffers backed by a `std::string`
+ */
+static void FinalizeString(napi_env env, void* data, void* hint) {
+  std::string* s = static_cast<std::string*>(hint);
+  int64_t adjusted;
+  napi_adjust_external_memory(env, -static_cast<int64_t>(s->size()),
+                              &adjusted);
+  delete s;
+}
+
+/**
+ * Finalizer for external buffers backed by a `PinnedValue`
+ */
+static void FinalizePinnedValue(napi_env env, void* data, void* hint) {
+  PinnedValue* value = static_cast<PinnedValue*>(hint);
+  int64_t adjusted;
+  napi_adjust_external_memory(env, -static_cast<int64_t>(value->slice_.size()),
+                              &adjusted);
+  delete value;
+}
+
+PinnedValue::PinnedValue(std::shared_ptr<rocksdb::Cache> cache)
+    : cache_(cache) {}
+
 Entry::Entry(const rocksdb::Slice* key, const rocksdb::Slice* value)
     : key_(key->data(), key->size()), value_(value->data(), value->size()) {}
 
@@ -29,15 +69,15 @@ void Entry::ConvertByMode(napi_env env, Mode mode, const bool keyAsBuffer,
     napi_value keyElement;
     napi_value valueElement;
 
-    Convert(env, &key_, keyAsBuffer, &keyElement);
-    Convert(env, &value_, valueAsBuffer, &valueElement);
+    ConvertMove(env, &key_, keyAsBuffer, &keyElement);
+    ConvertMove(env, &value_, valueAsBuffer, &valueElement);
 
     napi_set_element(env, *result, 0, keyElement);
     napi_set_element(env, *result, 1, valueElement);
   } else if (mode == Mode::keys) {
-    Convert(env, &key_, keyAsBuffer, result);
+    ConvertMove(env, &key_, keyAsBuffer, result);
   } else {
-    Convert(env, &value_, valueAsBuffer, result);
+    ConvertMove(env, &value_, valueAsBuffer, result);
   }
 }
 
@@ -52,12 +92,57 @@ void Entry::Convert(napi_env env, const std::string* s, const bool asBuffer,
   }
 }
 
-BaseIterator::BaseIterator(Database* database, const bool reverse,
-                           std::string* lt, std::string* lte, std::string* gt,
-                           std::string* gte, const int limit,
-                           const bool fillCache, const Snapshot* snapshot)
+void Entry::ConvertMove(napi_env env, std::string* s, const bool asBuffer,
+                        napi_value* result) {
+  if (s == NULL || !asBuffer || s->size() < kExternalBufferMinSize) {
+    return Convert(env, s, asBuffer, result);
+  }
+  std::string* owned = new std::string(std::move(*s));
+  napi_status status = napi_create_external_buffer(
+      env, owned->size(), const_cast<char*>(owned->data()), FinalizeString,
+      owned, result);
+  if (status != napi_ok) {
+    // Some runtimes disallow external buffers, fall back to copying
+    Convert(env, owned, asBuffer, result);
+    delete owned;
+    return;
+  }
+  // Let the GC account for memory it does not allocate itself
+  int64_t adjusted;
+  napi_adjust_external_memory(env, static_cast<int64_t>(owned->size()),
+                              &adjusted);
+}
+
+void Entry::ConvertPinned(napi_env env, PinnedValue* value,
+                          const bool asBuffer, napi_value* result) {
+  const rocksdb::Slice& s = value->slice_;
+  if (asBuffer && s.size() >= kExternalBufferMinSize) {
+    napi_status status = napi_create_external_buffer(
+        env, s.size(), const_cast<char*>(s.data()), FinalizePinnedValue, value,
+        result);
+    if (status == napi_ok) {
+      int64_t adjusted;
+      napi_adjust_external_memory(env, static_cast<int64_t>(s.size()),
+                                  &adjusted);
+      return;
+    }
+  }
+  if (asBuffer) {
+    napi_create_buffer_copy(env, s.size(), s.data(), NULL, result);
+  } else {
+    napi_create_string_utf8(env, s.data(), s.size(), result);
+  }
+  delete value;
+}
+
+BaseIterator::BaseIterator(Database* database, ColumnFamily* columnFamily,
+                           const bool reverse, std::string* lt,
+                           std::string* lte, std::string* gt, std::string* gte,
+                           const int limit, const bool fillCache,
+                           const Snapshot* snapshot)
     : database_(database),
       transaction_(nullptr),
+      columnFamily_(columnFamily),
       hasClosed_(false),
       didSeek_(false),
       reverse_(reverse),
@@ -66,23 +151,27 @@ BaseIterator::BaseIterator(Database* database, const bool reverse,
       gt_(gt),
       gte_(gte),
       limit_(limit),
-      count_(0) {
+      count_(0),
+      checkRange_(false) {
   LOG_DEBUG("BaseIterator:Constructing BaseIterator from Database\n");
   options_ = new rocksdb::ReadOptions();
   options_->fill_cache = fillCache;
   options_->verify_checksums = false;
   if (snapshot != nullptr) options_->snapshot = snapshot->snapshot();
-  iter_ = database->NewIterator(*options_);
+  SetBounds(columnFamily->prefixExtractor_.get());
+  iter_ = database->NewIterator(*options_, columnFamily->handle_);
   LOG_DEBUG("BaseIterator:Constructed BaseIterator from Database\n");
 }
 
-BaseIterator::BaseIterator(Transaction* transaction, const bool reverse,
+BaseIterator::BaseIterator(Transaction* transaction,
+                           ColumnFamily* columnFamily, const bool reverse,
                            std::string* lt, std::string* lte, std::string* gt,
                            std::string* gte, const int limit,
                            const bool fillCache,
                            const TransactionSnapshot* snapshot)
     : database_(nullptr),
       transaction_(transaction),
+      columnFamily_(columnFamily),
       hasClosed_(false),
       didSeek_(false),
       reverse_(reverse),
@@ -91,12 +180,14 @@ BaseIterator::BaseIterator(Transaction* transaction, const bool reverse,
       gt_(gt),
       gte_(gte),
       limit_(limit),
-      count_(0) {
+      count_(0),
+      checkRange_(true) {
   options_ = new rocksdb::ReadOptions();
   options_->fill_cache = fillCache;
   options_->verify_checksums = false;
   if (snapshot != nullptr) options_->snapshot = snapshot->snapshot();
-  iter_ = transaction->GetIterator(*options_);
+  SetBounds(columnFamily->prefixExtractor_.get());
+  iter_ = transaction->GetIterator(*options_, columnFamily->handle_);
 }
 
 BaseIterator::~BaseIterator() {
@@ -197,7 +288,8 @@ void BaseIterator::Seek(rocksdb::Slice& target) {
 
 bool BaseIterator::Valid() const {
   assert(!hasClosed_);
-  return iter_->Valid() && !OutOfRange(iter_->key());
+  if (!iter_->Valid()) return false;
+  return !checkRange_ || !OutOfRange(iter_->key());
 }
 
 bool BaseIterator::Increment() {
@@ -258,48 +350,131 @@ bool BaseIterator::OutOfRange(const rocksdb::Slice& target) const {
   return false;
 }
 
-Iterator::Iterator(Database* database, const uint32_t id, const bool reverse,
-                   const bool keys, const bool values, const int limit,
-                   std::string* lt, std::string* lte, std::string* gt,
-                   std::string* gte, const bool fillCache,
-                   const bool keyAsBuffer, const bool valueAsBuffer,
-                   const uint32_t highWaterMarkBytes, const Snapshot* snapshot)
-    : BaseIterator(database, reverse, lt, lte, gt, gte, limit, fillCache,
-                   snapshot),
+bool BaseIterator::Bounds(std::string* start, std::string* end) {
+  assert(!hasClosed_);
+  if (options_->iterate_lower_bound != nullptr) {
+    start->assign(lowerBound_.data(), lowerBound_.size());
+  } else {
+    start->clear();
+  }
+  if (options_->iterate_upper_bound != nullptr) {
+    end->assign(upperBound_.data(), upperBound_.size());
+  } else {
+    // Total order, prefix seeks need both bounds
+    iter_->SeekToLast();
+    if (!iter_->Valid()) return false;
+    const rocksdb::Slice last = iter_->key();
+    end->reserve(last.size() + 1);
+    end->assign(last.data(), last.size());
+    end->push_back('\0');
+  }
+  return start->compare(*end) < 0;
+}
+
+void BaseIterator::SetBounds(const rocksdb::SliceTransform* prefixExtractor) {
+  // The lte and gte options take precedence over lt and gt respectively
+  if (gte_ != NULL) {
+    lowerBound_ = rocksdb::Slice(*gte_);
+    options_->iterate_lower_bound = &lowerBound_;
+  } else if (gt_ != NULL) {
+    // The smallest key greater than `gt`
+    lowerBoundKey_.reserve(gt_->size() + 1);
+    lowerBoundKey_.append(*gt_);
+    lowerBoundKey_.push_back('\0');
+    lowerBound_ = rocksdb::Slice(lowerBoundKey_);
+    options_->iterate_lower_bound = &lowerBound_;
+  }
+  if (lte_ != NULL) {
+    // The smallest key greater than `lte`
+    upperBoundKey_.reserve(lte_->size() + 1);
+    upperBoundKey_.append(*lte_);
+    upperBoundKey_.push_back('\0');
+    upperBound_ = rocksdb::Slice(upperBoundKey_);
+    options_->iterate_upper_bound = &upperBound_;
+  } else if (lt_ != NULL) {
+    upperBound_ = rocksdb::Slice(*lt_);
+    options_->iterate_upper_bound = &upperBound_;
+  }
+  if (prefixExtractor == nullptr) return;
+  options_->total_order_seek = true;
+  if (reverse_ || options_->iterate_lower_bound == nullptr ||
+      options_->iterate_upper_bound == nullptr ||
+      !prefixExtractor->InDomain(lowerBound_)) {
+    return;
+  }
+  // Every key in the range shares the prefix when the upper bound is at
+  // most the prefix's successor, levels end in a 0x00 separator so that
+  // is the prefix with its last byte set to 0x01
+  const rocksdb::Slice prefix = prefixExtractor->Transform(lowerBound_);
+  std::string successor(prefix.data(), prefix.size());
+  successor.back() = 0x01;
+  if (upperBound_.compare(successor) <= 0) {
+    options_->total_order_seek = false;
+    options_->prefix_same_as_start = true;
+  }
+}
+
+Iterator::Iterator(Database* database, ColumnFamily* columnFamily,
+                   const uint32_t id, const bool reverse, const bool keys,
+                   const bool values, const int limit, std::string* lt,
+                   std::string* lte, std::string* gt, std::string* gte,
+                   const bool fillCache, const bool keyAsBuffer,
+                   const bool valueAsBuffer, const uint32_t highWaterMarkBytes,
+                   const bool keyPath, const bool prefetch,
+                   const Snapshot* snapshot)
+    : BaseIterator(database, columnFamily, reverse, lt, lte, gt, gte, limit,
+                   fillCache, snapshot),
       id_(id),
       keys_(keys),
       values_(values),
       keyAsBuffer_(keyAsBuffer),
       valueAsBuffer_(valueAsBuffer),
       highWaterMarkBytes_(highWaterMarkBytes),
+      keyPath_(keyPath),
+      prefetch_(prefetch),
       first_(true),
       nexting_(false),
       isClosing_(false),
       closeWorker_(nullptr),
+      prefetching_(false),
+      prefetched_(false),
+      prefetchMore_(false),
+      prefetchSize_(kPrefetchMinSize),
+      prefetchCallback_(nullptr),
+      seekPending_(false),
       ref_(nullptr) {
   LOG_DEBUG("Iterator %d:Constructing from Database\n", id_);
   LOG_DEBUG("Iterator %d:Constructed from Database\n", id_);
 }
 
-Iterator::Iterator(Transaction* transaction, const uint32_t id,
-                   const bool reverse, const bool keys, const bool values,
-                   const int limit, std::string* lt, std::string* lte,
-                   std::string* gt, std::string* gte, const bool fillCache,
-                   const bool keyAsBuffer, const bool valueAsBuffer,
-                   const uint32_t highWaterMarkBytes,
+Iterator::Iterator(Transaction* transaction, ColumnFamily* columnFamily,
+                   const uint32_t id, const bool reverse, const bool keys,
+                   const bool values, const int limit, std::string* lt,
+                   std::string* lte, std::string* gt, std::string* gte,
+                   const bool fillCache, const bool keyAsBuffer,
+                   const bool valueAsBuffer, const uint32_t highWaterMarkBytes,
+                   const bool keyPath, const bool prefetch,
                    const TransactionSnapshot* snapshot)
-    : BaseIterator(transaction, reverse, lt, lte, gt, gte, limit, fillCache,
-                   snapshot),
+    : BaseIterator(transaction, columnFamily, reverse, lt, lte, gt, gte, limit,
+                   fillCache, snapshot),
       id_(id),
       keys_(keys),
       values_(values),
       keyAsBuffer_(keyAsBuffer),
       valueAsBuffer_(valueAsBuffer),
       highWaterMarkBytes_(highWaterMarkBytes),
+      keyPath_(keyPath),
+      prefetch_(prefetch),
       first_(true),
       nexting_(false),
       isClosing_(false),
       closeWorker_(nullptr),
+      prefetching_(false),
+      prefetched_(false),
+      prefetchMore_(false),
+      prefetchSize_(kPrefetchMinSize),
+      prefetchCallback_(nullptr),
+      seekPending_(false),
       ref_(nullptr) {
   LOG_DEBUG("Iterator %d:Constructing from Transaction %d\n", id_,
             transaction->id_);
@@ -352,10 +527,19 @@ void Iterator::Close() {
   LOG_DEBUG("Iterator %d:Called %s\n", id_, __func__);
 }
 
-bool Iterator::ReadMany(uint32_t size) {
+bool Iterator::ReadMany(uint32_t size, const bool packed) {
   assert(!hasClosed_);
   cache_.clear();
-  cache_.reserve(size);
+  packedData_.clear();
+  packedOffsets_.clear();
+  readStatus_ = rocksdb::Status::OK();
+  if (packed) {
+    packedData_.reserve(highWaterMarkBytes_);
+    packedOffsets_.reserve(2 * static_cast<size_t>(size));
+  } else {
+    cache_.reserve(size);
+  }
+  uint32_t count = 0;
   size_t bytesRead = 0;
   rocksdb::Slice empty;
   while (true) {
@@ -365,22 +549,70 @@ bool Iterator::ReadMany(uint32_t size) {
       first_ = false;
     }
     if (!Valid() || !Increment()) break;
-    if (keys_ && values_) {
-      rocksdb::Slice k = CurrentKey();
-      rocksdb::Slice v = CurrentValue();
+    rocksdb::Slice k = keys_ ? CurrentKey() : empty;
+    rocksdb::Slice v = values_ ? CurrentValue() : empty;
+    if (packed && keyPath_) {
+      if (!AppendKeyPath(k)) return false;
+      packedData_.append(v.data(), v.size());
+      packedOffsets_.push_back(static_cast<uint32_t>(packedData_.size()));
+    } else if (packed) {
+      packedData_.append(k.data(), k.size());
+      packedOffsets_.push_back(static_cast<uint32_t>(packedData_.size()));
+      packedData_.append(v.data(), v.size());
+      packedOffsets_.push_back(static_cast<uint32_t>(packedData_.size()));
+    } else {
       cache_.emplace_back(&k, &v);
-      bytesRead += k.size() + v.size();
-    } else if (keys_) {
-      rocksdb::Slice k = CurrentKey();
-      cache_.emplace_back(&k, &empty);
-    } else if (values_) {
-      rocksdb::Slice v = CurrentValue();
-      cache_.emplace_back(&empty, &v);
-      bytesRead += v.size();
     }
-    if (bytesRead > highWaterMarkBytes_ || cache_.size() >= size) {
+    count++;
+    // Keys are only counted when values are included
+    bytesRead += values_ ? k.size() + v.size() : 0;
+    if (bytesRead > highWaterMarkBytes_ || count >= size) {
       return true;
     }
   }
   return false;
 }
+
+void Iterator::ConvertPacked(napi_env env, napi_value* data,
+                             napi_value* offsets) {
+  Entry::ConvertMove(env, &packedData_, true, data);
+  packedData_.clear();
+  void* offsetsData;
+  napi_value arrayBuffer;
+  napi_create_arraybuffer(env, packedOffsets_.size() * sizeof(uint32_t),
+                          &offsetsData, &arrayBuffer);
+  if (!packedOffsets_.empty()) {
+    memcpy(offsetsData, packedOffsets_.data(),
+           packedOffsets_.size() * sizeof(uint32_t));
+  }
+  napi_create_typedarray(env, napi_uint32_array, packedOffsets_.size(),
+                         arrayBuffer, 0, offsets);
+  packedOffsets_.clear();
+}
+
+void Iterator::AdaptPrefetchSize(const uint32_t size, const bool waited) {
+  // A waiting consumer is faster than reading, larger batches take fewer
+  // round trips, otherwise smaller batches read less ahead of a consumer
+  // that may stop early
+  const uint64_t next = waited ? static_cast<uint64_t>(prefetchSize_) * 2
+                               : prefetchSize_ / 2;
+  const uint32_t floor = std::min(kPrefetchMinSize, size);
+  prefetchSize_ = std::max(
+      floor, static_cast<uint32_t>(std::min<uint64_t>(next, size)));
+}
+
+bool Iterator::AppendKeyPath(const rocksdb::Slice& key) {
+  keyParts_.clear();
+  if (keys_) SplitKey(key, keyParts_);
+  packedOffsets_.push_back(static_cast<uint32_t>(keyParts_.size()));
+  for (const rocksdb::Slice& part : keyParts_) {
+    const size_t offset = packedData_.size();
+    packedData_.resize(offset + DecodedPartSize(part));
+    if (!DecodePart(part, &packedData_[offset])) {
+      readStatus_ = rocksdb::Status::Corruption("Non-Base128 character");
+      return false;
+    }
+    packedOffsets_.push_back(static_cast<uint32_t>(packedData_.size()));
+  }
+  return true;
+}
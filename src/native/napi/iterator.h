@@ -5,13 +5,17 @@
 #endif
 
 #include <cstdint>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include <node_api.h>
 #include <rocksdb/status.h>
 #include <rocksdb/options.h>
 #include <rocksdb/slice.h>
 #include <rocksdb/iterator.h>
+#include <rocksdb/cache.h>
+#include <rocksdb/slice_transform.h>
 
 #include "database.h"
 #include "transaction.h"
@@ -23,6 +27,18 @@
  */
 enum Mode { entries, keys, values };
 
+/**
+ * Value read into a `rocksdb::PinnableSlice`
+ * The slice may pin a block of the block cache, so the cache is kept alive
+ * for as long as the value is
+ */
+struct PinnedValue {
+  PinnedValue(std::shared_ptr<rocksdb::Cache> cache);
+
+  std::shared_ptr<rocksdb::Cache> cache_;
+  rocksdb::PinnableSlice slice_;
+};
+
 /**
  * Helper struct for caching and converting a key-value pair to napi_values.
  */
@@ -35,6 +51,23 @@ struct Entry {
   static void Convert(napi_env env, const std::string* s, const bool asBuffer,
                       napi_value* result);
 
+  /**
+   * Converts `s` to a napi_value, taking over its contents when it is large
+   * Large buffers are handed to JS as external buffers without copying,
+   * leaving `s` empty, small ones are copied since that is cheaper
+   */
+  static void ConvertMove(napi_env env, std::string* s, const bool asBuffer,
+                          napi_value* result);
+
+  /**
+   * Converts `value` to a napi_value, taking ownership of it
+   * Large buffers are handed to JS as external buffers keeping the pinned
+   * block alive until they are finalized, otherwise `value` is copied and
+   * deleted straight away
+   */
+  static void ConvertPinned(napi_env env, PinnedValue* value,
+                            const bool asBuffer, napi_value* result);
+
  private:
   std::string key_;
   std::string value_;
@@ -48,17 +81,18 @@ struct BaseIterator {
   /**
    * Constructs iterator from database
    */
-  BaseIterator(Database* database, const bool reverse, std::string* lt,
-               std::string* lte, std::string* gt, std::string* gte,
-               const int limit, const bool fillCache,
-               const Snapshot* snapshot = nullptr);
+  BaseIterator(Database* database, ColumnFamily* columnFamily,
+               const bool reverse, std::string* lt, std::string* lte,
+               std::string* gt, std::string* gte, const int limit,
+               const bool fillCache, const Snapshot* snapshot = nullptr);
 
   /**
    * Constructs iterator from transaction
    */
-  BaseIterator(Transaction* transaction, const bool reverse, std::string* lt,
-               std::string* lte, std::string* gt, std::string* gte,
-               const int limit, const bool fillCache,
+  BaseIterator(Transaction* transaction, ColumnFamily* columnFamily,
+               const bool reverse, std::string* lt, std::string* lte,
+               std::string* gt, std::string* gte, const int limit,
+               const bool fillCache,
                const TransactionSnapshot* snapshot = nullptr);
 
   /**
@@ -105,11 +139,28 @@ struct BaseIterator {
 
   bool OutOfRange(const rocksdb::Slice& target) const;
 
+  /**
+   * Gets the range as `[start, end)` for `DeleteRange`
+   * Without an upper bound `end` is just past the last key in the range
+   * Returns false when the range has no keys, check `Status` then
+   */
+  bool Bounds(std::string* start, std::string* end);
+
   Database* database_;
   Transaction* transaction_;
+  ColumnFamily* columnFamily_;
   bool hasClosed_;
 
  private:
+  /**
+   * Turns the range options into `iterate_lower_bound` and
+   * `iterate_upper_bound` so RocksDB can skip files and blocks outside the
+   * range
+   * Forward iterators confined to a single prefix of `prefixExtractor` use
+   * prefix seeks, all others seek in total order
+   */
+  void SetBounds(const rocksdb::SliceTransform* prefixExtractor);
+
   rocksdb::Iterator* iter_;
   bool didSeek_;
   const bool reverse_;
@@ -120,6 +171,19 @@ struct BaseIterator {
   const int limit_;
   int count_;
   rocksdb::ReadOptions* options_;
+  /**
+   * Bounds are exclusive above and inclusive below, `gt` and `lte` are
+   * turned into their immediate successor keys
+   */
+  std::string lowerBoundKey_;
+  std::string upperBoundKey_;
+  rocksdb::Slice lowerBound_;
+  rocksdb::Slice upperBound_;
+  /**
+   * Transaction iterators merge in the transaction's own writes, which
+   * are not limited by the bounds, so they still check every key
+   */
+  const bool checkRange_;
 };
 
 /**
@@ -131,22 +195,25 @@ struct Iterator final : public BaseIterator {
    * Constructs iterator from database
    * Call `Iterator::Attach` afterwards
    */
-  Iterator(Database* database, const uint32_t id, const bool reverse,
-           const bool keys, const bool values, const int limit, std::string* lt,
-           std::string* lte, std::string* gt, std::string* gte,
-           const bool fillCache, const bool keyAsBuffer,
-           const bool valueAsBuffer, const uint32_t highWaterMarkBytes,
-           const Snapshot* snapshot = nullptr);
+  Iterator(Database* database, ColumnFamily* columnFamily, const uint32_t id,
+           const bool reverse, const bool keys, const bool values,
+           const int limit, std::string* lt, std::string* lte,
+           std::string* gt, std::string* gte, const bool fillCache,
+           const bool keyAsBuffer, const bool valueAsBuffer,
+           const uint32_t highWaterMarkBytes, const bool keyPath,
+           const bool prefetch, const Snapshot* snapshot = nullptr);
 
   /**
    * Constructs iterator from transaction
    * Call `Iterator::Attach` afterwards
    */
-  Iterator(Transaction* transaction, const uint32_t id, const bool reverse,
-           const bool keys, const bool values, const int limit, std::string* lt,
+  Iterator(Transaction* transaction, ColumnFamily* columnFamily,
+           const uint32_t id, const bool reverse, const bool keys,
+           const bool values, const int limit, std::string* lt,
            std::string* lte, std::string* gt, std::string* gte,
            const bool fillCache, const bool keyAsBuffer,
            const bool valueAsBuffer, const uint32_t highWaterMarkBytes,
+           const bool keyPath, const bool prefetch,
            const TransactionSnapshot* snapshot = nullptr);
 
   ~Iterator() override;
@@ -170,7 +237,27 @@ struct Iterator final : public BaseIterator {
 
   void Close() override;
 
-  bool ReadMany(uint32_t size);
+  /**
+   * Reads up to `size` entries or `highWaterMarkBytes_` bytes
+   * Entries go into `cache_`, or into `packedData_` and `packedOffsets_`
+   * when `packed` is set
+   * Returns false when the iterator is exhausted or a key could not be
+   * parsed, in which case `readStatus_` is set
+   */
+  bool ReadMany(uint32_t size, const bool packed = false);
+
+  /**
+   * Converts the packed batch to a Buffer and a `Uint32Array` of offsets
+   * The packed batch is left empty so it can be read into again
+   */
+  void ConvertPacked(napi_env env, napi_value* data, napi_value* offsets);
+
+  /**
+   * Adapts `prefetchSize_` to the consumer, `waited` is whether it asked
+   * for the batch before the prefetch had finished
+   * The size stays within the `size` the consumer asks for
+   */
+  void AdaptPrefetchSize(const uint32_t size, const bool waited);
 
   const uint32_t id_;
   const bool keys_;
@@ -178,6 +265,15 @@ struct Iterator final : public BaseIterator {
   const bool keyAsBuffer_;
   const bool valueAsBuffer_;
   const uint32_t highWaterMarkBytes_;
+  /**
+   * Packed batches split and decode keys into their KeyPath parts
+   */
+  const bool keyPath_;
+  /**
+   * Packed batches are read in the background as soon as the previous
+   * batch is delivered
+   */
+  const bool prefetch_;
   bool first_;
   bool nexting_;
   /**
@@ -187,7 +283,42 @@ struct Iterator final : public BaseIterator {
   bool isClosing_;
   BaseWorker* closeWorker_;
   std::vector<Entry> cache_;
+  /**
+   * Packed batch, all keys and values concatenated in iteration order
+   * `packedOffsets_` holds the end offset of each key followed by the end
+   * offset of its value
+   * With `keyPath_` each entry is instead the number of key parts, the end
+   * offset of each decoded part and then the end offset of the value
+   */
+  std::string packedData_;
+  std::vector<uint32_t> packedOffsets_;
+  rocksdb::Status readStatus_;
+  /**
+   * Prefetch state, this is managed by workers
+   * `prefetching_` is set while a prefetch is reading into the packed batch
+   * and `prefetched_` once it holds a batch that has not been delivered
+   */
+  bool prefetching_;
+  bool prefetched_;
+  bool prefetchMore_;
+  rocksdb::Status prefetchStatus_;
+  uint32_t prefetchSize_;
+  /**
+   * Callback of a batch request that arrived during the prefetch
+   */
+  napi_ref prefetchCallback_;
+  /**
+   * Seeks during the prefetch are applied once it has finished
+   */
+  bool seekPending_;
+  std::string seekTarget_;
 
  private:
+  /**
+   * Appends the decoded KeyPath parts of `key` to the packed batch
+   */
+  bool AppendKeyPath(const rocksdb::Slice& key);
+
+  std::vector<rocksdb::Slice> keyParts_;
   napi_ref ref_;
 };
@@ -0,0 +1,207 @@
+#include "keypath.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <rocksdb/slice.h>
+#include <rocksdb/slice_transform.h>
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+static const char kSep = 0x00;
+
+static const char kEmpty = 0x01;
+
+static const uint8_t kAlphabetStart = 0x02;
+
+/**
+ * Lanes of 7 bits, one per byte
+ */
+static const uint64_t kLanes = 0x7f7f7f7f7f7f7f7full;
+
+static const uint64_t kAlphabetStarts = 0x0202020202020202ull;
+
+static const uint64_t kHighBits = 0x8080808080808080ull;
+
+/**
+ * Compilers turn these loops into a single load or store and a byte swap
+ */
+static inline uint64_t LoadBigEndian(const char* p, size_t n) {
+  uint64_t v = 0;
+  for (size_t i = 0; i < n; i++) v = (v << 8) | static_cast<uint8_t>(p[i]);
+  return v;
+}
+
+static inline void StoreBigEndian(uint64_t v, char* p, size_t n) {
+  for (size_t i = n; i > 0; i--) {
+    p[i - 1] = static_cast<char>(v & 0xff);
+    v >>= 8;
+  }
+}
+
+/**
+ * Spreads the low 56 bits of `v` into 8 lanes of 7 bits
+ * The most significant lane holds the most significant bits
+ */
+static inline uint64_t Spread(uint64_t v) {
+#if defined(__BMI2__)
+  return _pdep_u64(v, kLanes);
+#else
+  v = (v & 0x000000000fffffffull) | ((v & 0x00fffffff0000000ull) << 4);
+  v = (v & 0x00003fff00003fffull) | ((v & 0x0fffc0000fffc000ull) << 2);
+  v = (v & 0x007f007f007f007full) | ((v & 0x3f803f803f803f80ull) << 1);
+  return v;
+#endif
+}
+
+/**
+ * Inverse of `Spread`
+ */
+static inline uint64_t Gather(uint64_t v) {
+#if defined(__BMI2__)
+  return _pext_u64(v, kLanes);
+#else
+  v = (v & 0x007f007f007f007full) | ((v & 0x7f007f007f007f00ull) >> 1);
+  v = (v & 0x00003fff00003fffull) | ((v & 0x3fff00003fff0000ull) >> 2);
+  v = (v & 0x000000000fffffffull) | ((v & 0x0fffffff00000000ull) >> 4);
+  return v;
+#endif
+}
+
+size_t EncodedPartSize(size_t size) {
+  if (size == 0) return 1;
+  return (size * 8 + 6) / 7;
+}
+
+size_t DecodedPartSize(const rocksdb::Slice& part) {
+  if (part.size() == 1 && part[0] == kEmpty) return 0;
+  return part.size() * 7 / 8;
+}
+
+char* EncodePart(const rocksdb::Slice& part, char* out) {
+  if (part.empty()) {
+    *out++ = kEmpty;
+    return out;
+  }
+  const char* in = part.data();
+  size_t n = part.size();
+  // Every 7 bytes are exactly 8 characters
+  for (; n >= 7; n -= 7, in += 7, out += 8) {
+    StoreBigEndian(Spread(LoadBigEndian(in, 7)) + kAlphabetStarts, out, 8);
+  }
+  // Remaining bytes, MSB first, the partial character is left aligned
+  uint32_t buffer = 0;
+  uint32_t bits = 0;
+  for (size_t i = 0; i < n; i++) {
+    buffer = (buffer << 8) | static_cast<uint8_t>(in[i]);
+    bits += 8;
+    while (bits > 7) {
+      bits -= 7;
+      *out++ = static_cast<char>(kAlphabetStart + (0x7f & (buffer >> bits)));
+    }
+  }
+  if (bits) {
+    *out++ =
+        static_cast<char>(kAlphabetStart + (0x7f & (buffer << (7 - bits))));
+  }
+  return out;
+}
+
+bool DecodePart(const rocksdb::Slice& part, char* out) {
+  if (part.size() == 1 && part[0] == kEmpty) return true;
+  const char* in = part.data();
+  size_t n = part.size();
+  // Every 8 characters are exactly 7 bytes
+  for (; n >= 8; n -= 8, in += 8, out += 7) {
+    uint64_t v = LoadBigEndian(in, 8);
+    // A lane below the alphabet borrows into its high bit
+    // a lane above it has its high bit set after subtracting
+    if (((v - kAlphabetStarts) & ~v & kHighBits) != 0) return false;
+    v -= kAlphabetStarts;
+    if ((v & kHighBits) != 0) return false;
+    StoreBigEndian(Gather(v), out, 7);
+  }
+  uint32_t buffer = 0;
+  uint32_t bits = 0;
+  for (size_t i = 0; i < n; i++) {
+    const uint8_t c = static_cast<uint8_t>(in[i]);
+    if (c < kAlphabetStart || c >= kAlphabetStart + 128) return false;
+    buffer = ((buffer << 7) | (c - kAlphabetStart)) & 0xffff;
+    bits += 7;
+    if (bits >= 8) {
+      bits -= 8;
+      *out++ = static_cast<char>(0xff & (buffer >> bits));
+    }
+  }
+  return true;
+}
+
+void SplitKey(const rocksdb::Slice& key, std::vector<rocksdb::Slice>& parts) {
+  const char* data = key.data();
+  const size_t size = key.size();
+  size_t pos = 0;
+  // Levels are `sep level sep`, like `parseKey` anything preceding the
+  // starting separator is skipped
+  while (pos < size) {
+    const void* start = memchr(data + pos, kSep, size - pos);
+    if (start == nullptr) break;
+    const size_t levelStart = static_cast<const char*>(start) - data + 1;
+    const void* end = memchr(data + levelStart, kSep, size - levelStart);
+    if (end == nullptr) break;
+    const size_t levelEnd = static_cast<const char*>(end) - data;
+    parts.emplace_back(data + levelStart, levelEnd - levelStart);
+    pos = levelEnd + 1;
+  }
+  parts.emplace_back(data + pos, size - pos);
+}
+
+/**
+ * The name is persisted in table properties, filters built with a
+ * different number of levels are not used
+ */
+class LevelPathTransform : public rocksdb::SliceTransform {
+ public:
+  explicit LevelPathTransform(size_t levels)
+      : levels_(levels),
+        name_("js-db.LevelPathTransform." + std::to_string(levels)) {}
+
+  const char* Name() const override { return name_.c_str(); }
+
+  rocksdb::Slice Transform(const rocksdb::Slice& key) const override {
+    return rocksdb::Slice(key.data(), PrefixSize(key));
+  }
+
+  bool InDomain(const rocksdb::Slice& key) const override {
+    return PrefixSize(key) > 0;
+  }
+
+ private:
+  /**
+   * Size of the leading levels, 0 when `key` has fewer levels
+   * Unlike `SplitKey` levels must start right at the beginning of the key
+   */
+  size_t PrefixSize(const rocksdb::Slice& key) const {
+    const char* data = key.data();
+    const size_t size = key.size();
+    size_t pos = 0;
+    for (size_t i = 0; i < levels_; i++) {
+      if (pos >= size || data[pos] != kSep) return 0;
+      const void* end = memchr(data + pos + 1, kSep, size - pos - 1);
+      if (end == nullptr) return 0;
+      pos = static_cast<const char*>(end) - data + 1;
+    }
+    return pos;
+  }
+
+  const size_t levels_;
+  const std::string name_;
+};
+
+const rocksdb::SliceTransform* NewLevelPathTransform(size_t levels) {
+  return new LevelPathTransform(levels);
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <rocksdb/slice.h>
+#include <rocksdb/slice_transform.h>
+
+/**
+ * Native KeyPath encoding, see `src/utils.ts` for the reference
+ * implementation
+ *
+ * Key parts are encoded with a lexicographically ordered base 128 alphabet
+ * starting at 0x02, empty parts are encoded as a single 0x01 byte and levels
+ * are wrapped in 0x00 separators
+ * Full blocks of 7 bytes map to 8 characters and are converted a whole
+ * 64-bit word at a time, only the tail goes byte by byte
+ */
+
+/**
+ * Length of the encoding of a part of `size` bytes
+ */
+size_t EncodedPartSize(size_t size);
+
+/**
+ * Length of the decoding of the encoded part `part`
+ */
+size_t DecodedPartSize(const rocksdb::Slice& part);
+
+/**
+ * Encodes `part` into `out`, which must have room for `EncodedPartSize`
+ * Returns the end of the written output
+ */
+char* EncodePart(const rocksdb::Slice& part, char* out);
+
+/**
+ * Decodes `part` into `out`, which must have room for `DecodedPartSize`
+ * Returns false if `part` contains a non-base128 character
+ */
+bool DecodePart(const rocksdb::Slice& part, char* out);
+
+/**
+ * Splits a key into its encoded level parts followed by the encoded key
+ * actual part
+ * This never fails, bytes that do not form a level are part of the key
+ * actual part
+ */
+void SplitKey(const rocksdb::Slice& key, std::vector<rocksdb::Slice>& parts);
+
+/**
+ * Prefix extractor taking the leading `levels` levels of a key
+ * Keys with fewer levels are outside of its domain
+ */
+const rocksdb::SliceTransform* NewLevelPathTransform(size_t levels);
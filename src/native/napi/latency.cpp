@@ -0,0 +1,61 @@
+#include "latency.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+LatencyHistogram::LatencyHistogram() : count_(0), sum_(0), max_(0) {
+  for (size_t i = 0; i < kBuckets; i++) buckets_[i] = 0;
+}
+
+void LatencyHistogram::Record(std::chrono::steady_clock::duration duration) {
+  const int64_t elapsed =
+      std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+  const uint64_t micros = elapsed > 0 ? static_cast<uint64_t>(elapsed) : 0;
+  size_t bucket = 0;
+  for (uint64_t v = micros >> 1; v != 0 && bucket < kBuckets - 1; v >>= 1) {
+    bucket++;
+  }
+  buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  sum_.fetch_add(micros, std::memory_order_relaxed);
+  uint64_t max = max_.load(std::memory_order_relaxed);
+  while (micros > max &&
+         !max_.compare_exchange_weak(max, micros, std::memory_order_relaxed)) {
+  }
+}
+
+static std::mutex registryMutex;
+
+/**
+ * Worker threads of Node.js load the addon once per process, so the
+ * registry is shared between them
+ */
+static std::map<std::string, WorkerLatency*>& Registry() {
+  static std::map<std::string, WorkerLatency*>* registry =
+      new std::map<std::string, WorkerLatency*>();
+  return *registry;
+}
+
+WorkerLatency* GetWorkerLatency(const char* resourceName) {
+  // Resource names are literals, so each thread caches them by address and
+  // only locks the registry the first time it sees a name
+  thread_local std::unordered_map<const char*, WorkerLatency*> cache;
+  WorkerLatency*& cached = cache[resourceName];
+  if (cached != nullptr) return cached;
+  std::lock_guard<std::mutex> lock(registryMutex);
+  WorkerLatency*& latency = Registry()[resourceName];
+  if (latency == nullptr) latency = new WorkerLatency();
+  cached = latency;
+  return latency;
+}
+
+std::map<std::string, WorkerLatency*> GetWorkerLatencies() {
+  std::lock_guard<std::mutex> lock(registryMutex);
+  return Registry();
+}
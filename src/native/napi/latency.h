@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+
+/**
+ * Latency histogram with log2 buckets of microseconds
+ * Bucket `i` counts latencies below `2^(i + 1)` microseconds, the last
+ * bucket counts everything above
+ * Recording only uses relaxed atomic increments, so it can be done from any
+ * thread
+ */
+struct LatencyHistogram {
+  static const size_t kBuckets = 32;
+
+  LatencyHistogram();
+
+  void Record(std::chrono::steady_clock::duration duration);
+
+  std::atomic<uint64_t> buckets_[kBuckets];
+  std::atomic<uint64_t> count_;
+  std::atomic<uint64_t> sum_;
+  std::atomic<uint64_t> max_;
+};
+
+/**
+ * Latencies of the workers of a resource name
+ */
+struct WorkerLatency {
+  /**
+   * From being queued until execution starts on a pool thread
+   */
+  LatencyHistogram queue_;
+  /**
+   * Execution on a pool thread
+   */
+  LatencyHistogram execute_;
+  /**
+   * Conversion of the results and the callback on the main thread
+   */
+  LatencyHistogram complete_;
+};
+
+/**
+ * Gets the latencies of the literal `resourceName`, creating them on first
+ * use
+ * The latencies live until the process exits, so workers can keep them
+ */
+WorkerLatency* GetWorkerLatency(const char* resourceName);
+
+/**
+ * Copies the registry, it is only locked while copying
+ */
+std::map<std::string, WorkerLatency*> GetWorkerLatencies();
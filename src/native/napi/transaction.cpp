@@ -117,46 +117,58 @@ const rocksdb::Snapshot* Transaction::GetSnapshot() {
 }
 
 rocksdb::Iterator* Transaction::GetIterator(
-    const rocksdb::ReadOptions& options) {
+    const rocksdb::ReadOptions& options,
+    rocksdb::ColumnFamilyHandle* columnFamily) {
   assert(!hasCommitted_ && !hasRollbacked_);
-  return tran_->GetIterator(options);
+  return tran_->GetIterator(options, columnFamily);
 }
 
 rocksdb::Status Transaction::Get(const rocksdb::ReadOptions& options,
-                                 rocksdb::Slice key, std::string& value) {
+                                 rocksdb::ColumnFamilyHandle* columnFamily,
+                                 rocksdb::Slice key,
+                                 rocksdb::PinnableSlice* value) {
   assert(!hasCommitted_ && !hasRollbacked_);
-  return tran_->Get(options, key, &value);
+  return tran_->Get(options, columnFamily, key, value);
 }
 
-rocksdb::Status Transaction::GetForUpdate(const rocksdb::ReadOptions& options,
-                                          rocksdb::Slice key,
-                                          std::string& value, bool exclusive) {
+rocksdb::Status Transaction::GetForUpdate(
+    const rocksdb::ReadOptions& options,
+    rocksdb::ColumnFamilyHandle* columnFamily, rocksdb::Slice key,
+    rocksdb::PinnableSlice* value, bool exclusive) {
   assert(!hasCommitted_ && !hasRollbacked_);
-  return tran_->GetForUpdate(options, key, &value, exclusive);
+  return tran_->GetForUpdate(options, columnFamily, key, value, exclusive);
 }
 
-rocksdb::Status Transaction::Put(rocksdb::Slice key, rocksdb::Slice value) {
+rocksdb::Status Transaction::Put(rocksdb::ColumnFamilyHandle* columnFamily,
+                                 rocksdb::Slice key, rocksdb::Slice value) {
   assert(!hasCommitted_ && !hasRollbacked_);
-  return tran_->Put(key, value);
+  return tran_->Put(columnFamily, key, value);
 }
 
-rocksdb::Status Transaction::Del(rocksdb::Slice key) {
+rocksdb::Status Transaction::Del(rocksdb::ColumnFamilyHandle* columnFamily,
+                                 rocksdb::Slice key) {
   assert(!hasCommitted_ && !hasRollbacked_);
-  return tran_->Delete(key);
+  return tran_->Delete(columnFamily, key);
 }
 
-std::vector<rocksdb::Status> Transaction::MultiGet(
-    const rocksdb::ReadOptions& options,
-    const std::vector<rocksdb::Slice>& keys, std::vector<std::string>& values) {
+void Transaction::MultiGet(const rocksdb::ReadOptions& options,
+                           rocksdb::ColumnFamilyHandle* columnFamily,
+                           const size_t numKeys, const rocksdb::Slice* keys,
+                           rocksdb::PinnableSlice* values,
+                           rocksdb::Status* statuses, const bool sortedInput) {
   assert(!hasCommitted_ && !hasRollbacked_);
-  return tran_->MultiGet(options, keys, &values);
+  tran_->MultiGet(options, columnFamily, numKeys, keys, values, statuses,
+                  sortedInput);
 }
 
 std::vector<rocksdb::Status> Transaction::MultiGetForUpdate(
     const rocksdb::ReadOptions& options,
+    rocksdb::ColumnFamilyHandle* columnFamily,
     const std::vector<rocksdb::Slice>& keys, std::vector<std::string>& values) {
   assert(!hasCommitted_ && !hasRollbacked_);
-  return tran_->MultiGetForUpdate(options, keys, &values);
+  const std::vector<rocksdb::ColumnFamilyHandle*> columnFamilies(keys.size(),
+                                                                 columnFamily);
+  return tran_->MultiGetForUpdate(options, columnFamilies, keys, &values);
 }
 
 void Transaction::AttachIterator(napi_env env, uint32_t id,
@@ -89,15 +89,17 @@ struct Transaction final {
    * before default to the underlying DB value, this includes deleted values
    * Setting a read snapshot only affects what is read from the DB
    */
-  rocksdb::Iterator* GetIterator(const rocksdb::ReadOptions& options);
+  rocksdb::Iterator* GetIterator(const rocksdb::ReadOptions& options,
+                                 rocksdb::ColumnFamilyHandle* columnFamily);
 
   /**
    * Get a value
    * This will read from the transaction overlay and default to the underlying
    * db Use a snapshot for consistent reads
    */
-  rocksdb::Status Get(const rocksdb::ReadOptions& options, rocksdb::Slice key,
-                      std::string& value);
+  rocksdb::Status Get(const rocksdb::ReadOptions& options,
+                      rocksdb::ColumnFamilyHandle* columnFamily,
+                      rocksdb::Slice key, rocksdb::PinnableSlice* value);
 
   /**
    * Get a value for update
@@ -106,21 +108,27 @@ struct Transaction final {
    * snapshot for consistent reads
    */
   rocksdb::Status GetForUpdate(const rocksdb::ReadOptions& options,
-                               rocksdb::Slice key, std::string& value,
+                               rocksdb::ColumnFamilyHandle* columnFamily,
+                               rocksdb::Slice key,
+                               rocksdb::PinnableSlice* value,
                                bool exclusive = true);
 
   /**
-   * Get multiple values
+   * Get multiple values with batched lookups
+   * Set `sortedInput` when `keys` are in ascending order
    */
-  std::vector<rocksdb::Status> MultiGet(const rocksdb::ReadOptions& options,
-                                        const std::vector<rocksdb::Slice>& keys,
-                                        std::vector<std::string>& values);
+  void MultiGet(const rocksdb::ReadOptions& options,
+                rocksdb::ColumnFamilyHandle* columnFamily,
+                const size_t numKeys, const rocksdb::Slice* keys,
+                rocksdb::PinnableSlice* values, rocksdb::Status* statuses,
+                const bool sortedInput = false);
 
   /**
    * Get multiple values for update
    */
   std::vector<rocksdb::Status> MultiGetForUpdate(
       const rocksdb::ReadOptions& options,
+      rocksdb::ColumnFamilyHandle* columnFamily,
       const std::vector<rocksdb::Slice>& keys,
       std::vector<std::string>& values);
 
@@ -132,7 +140,8 @@ struct Transaction final {
    * snapshot is set that is also written to by this transaction, will cause a
    * conflict
    */
-  rocksdb::Status Put(rocksdb::Slice key, rocksdb::Slice value);
+  rocksdb::Status Put(rocksdb::ColumnFamilyHandle* columnFamily,
+                      rocksdb::Slice key, rocksdb::Slice value);
 
   /**
    * Delete a key value
@@ -142,7 +151,8 @@ struct Transaction final {
    * snapshot is set that is also written to by this transaction, will cause a
    * conflict
    */
-  rocksdb::Status Del(rocksdb::Slice key);
+  rocksdb::Status Del(rocksdb::ColumnFamilyHandle* columnFamily,
+                      rocksdb::Slice key);
 
   /**
    * Attach `Iterator` to be managed by this `Transaction`
@@ -2,7 +2,14 @@
 
 #include "utils.h"
 
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <numeric>
+#include <vector>
+
 #include <rocksdb/env.h>
+#include <rocksdb/status.h>
 
 void NullLogger::Logv(const char* format, va_list ap) {}
 
@@ -62,6 +69,42 @@ napi_value CreateCodeError(napi_env env, const char* code, const char* msg) {
   return error;
 }
 
+napi_value CreateSyntaxError(napi_env env, const char* msg) {
+  napi_value global;
+  napi_get_global(env, &global);
+  napi_value constructor;
+  napi_get_named_property(env, global, "SyntaxError", &constructor);
+  napi_value msgValue;
+  napi_create_string_utf8(env, msg, strlen(msg), &msgValue);
+  napi_value error;
+  napi_new_instance(env, constructor, 1, &msgValue, &error);
+  return error;
+}
+
+napi_value CreateStatusError(napi_env env, const rocksdb::Status& status,
+                             const char* msg) {
+  if (status.IsNotFound()) {
+    return CreateCodeError(env, "NOT_FOUND", msg);
+  } else if (status.IsCorruption()) {
+    return CreateCodeError(env, "CORRUPTION", msg);
+  } else if (status.IsIOError()) {
+    if (strlen(msg) > 15 &&
+        strncmp("IO error: lock ", msg, 15) == 0) {  // fs_posix.cc
+      return CreateCodeError(env, "LOCKED", msg);
+    } else if (strlen(msg) > 32 &&
+               strncmp("IO error: Failed to create lock ", msg, 32) ==
+                   0) {  // env_win.cc
+      return CreateCodeError(env, "LOCKED", msg);
+    } else {
+      return CreateCodeError(env, "IO_ERROR", msg);
+    }
+  } else if (status.IsBusy()) {
+    return CreateCodeError(env, "TRANSACTION_CONFLICT", msg);
+  } else {
+    return CreateError(env, msg);
+  }
+}
+
 bool HasProperty(napi_env env, napi_value obj, const char* key) {
   bool has = false;
   napi_has_named_property(env, obj, key, &has);
@@ -111,6 +154,30 @@ uint32_t Uint32Property(napi_env env, napi_value obj, const char* key,
   return DEFAULT;
 }
 
+uint64_t Uint64Property(napi_env env, napi_value obj, const char* key,
+                        uint64_t DEFAULT) {
+  if (HasProperty(env, obj, key)) {
+    napi_value value = GetProperty(env, obj, key);
+    int64_t result;
+    napi_get_value_int64(env, value, &result);
+    return result < 0 ? 0 : static_cast<uint64_t>(result);
+  }
+
+  return DEFAULT;
+}
+
+double DoubleProperty(napi_env env, napi_value obj, const char* key,
+                      double DEFAULT) {
+  if (HasProperty(env, obj, key)) {
+    napi_value value = GetProperty(env, obj, key);
+    double result;
+    napi_get_value_double(env, value, &result);
+    return result;
+  }
+
+  return DEFAULT;
+}
+
 int Int32Property(napi_env env, napi_value obj, const char* key, int DEFAULT) {
   if (HasProperty(env, obj, key)) {
     napi_value value = GetProperty(env, obj, key);
@@ -177,11 +244,74 @@ const TransactionSnapshot* TransactionSnapshotProperty(napi_env env,
   return snapshot;
 }
 
+ColumnFamily* ColumnFamilyProperty(napi_env env, napi_value obj,
+                                   const char* key, Database* database) {
+  if (!HasProperty(env, obj, key)) {
+    return database->defaultColumnFamily_;
+  }
+  napi_value value = GetProperty(env, obj, key);
+  if (!IsExternal(env, value)) {
+    return database->defaultColumnFamily_;
+  }
+  ColumnFamily* columnFamily = NULL;
+  NAPI_STATUS_THROWS(
+      napi_get_value_external(env, value, (void**)&columnFamily));
+  if (!database->OwnsColumnFamily(columnFamily)) {
+    napi_throw_error(env, "COLUMN_FAMILY_INVALID",
+                     "Column family does not belong to the database");
+    return nullptr;
+  }
+  return columnFamily;
+}
+
+std::shared_ptr<rocksdb::Cache> CacheProperty(napi_env env, napi_value obj,
+                                              const char* key) {
+  if (!HasProperty(env, obj, key)) {
+    return nullptr;
+  }
+  napi_value value = GetProperty(env, obj, key);
+  if (!IsExternal(env, value)) {
+    return nullptr;
+  }
+  std::shared_ptr<rocksdb::Cache>* cache = NULL;
+  NAPI_STATUS_THROWS(napi_get_value_external(env, value, (void**)&cache));
+  return *cache;
+}
+
+std::shared_ptr<rocksdb::WriteBufferManager> WriteBufferManagerProperty(
+    napi_env env, napi_value obj, const char* key) {
+  if (!HasProperty(env, obj, key)) {
+    return nullptr;
+  }
+  napi_value value = GetProperty(env, obj, key);
+  if (!IsExternal(env, value)) {
+    return nullptr;
+  }
+  std::shared_ptr<rocksdb::WriteBufferManager>* writeBufferManager = NULL;
+  NAPI_STATUS_THROWS(
+      napi_get_value_external(env, value, (void**)&writeBufferManager));
+  return *writeBufferManager;
+}
+
 void DisposeSliceBuffer(rocksdb::Slice slice) {
   if (!slice.empty()) delete[] slice.data();
 }
 
+rocksdb::Slice CopySlice(const char* data, const size_t size) {
+  // Empty slices are never disposed, so they must not be allocated
+  if (size == 0) return rocksdb::Slice();
+  char* to = new char[size];
+  memcpy(to, data, size);
+  return rocksdb::Slice(to, size);
+}
+
 rocksdb::Slice ToSlice(napi_env env, napi_value from) {
+  if (IsBuffer(env, from)) {
+    char* data = nullptr;
+    size_t size = 0;
+    napi_get_buffer_info(env, from, (void**)&data, &size);
+    return CopySlice(data, size);
+  }
   LD_STRING_OR_BUFFER_TO_COPY(env, from, to);
   return rocksdb::Slice(toCh_, toSz_);
 }
@@ -227,6 +357,15 @@ std::vector<rocksdb::Slice>* KeyArray(napi_env env, napi_value arr) {
   return result;
 }
 
+std::vector<size_t> SortedKeyOrder(const std::vector<rocksdb::Slice>& keys) {
+  std::vector<size_t> order(keys.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&keys](size_t a, size_t b) {
+    return keys[a].compare(keys[b]) < 0;
+  });
+  return order;
+}
+
 napi_status CallFunction(napi_env env, napi_value callback, const int argc,
                          napi_value* argv) {
   napi_value global;
@@ -4,13 +4,18 @@
 #define NAPI_VERSION 3
 #endif
 
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include <napi-macros.h>
 #include <node_api.h>
+#include <rocksdb/cache.h>
 #include <rocksdb/env.h>
 #include <rocksdb/slice.h>
+#include <rocksdb/status.h>
+#include <rocksdb/write_buffer_manager.h>
 
 #include "database.h"
 #include "iterator.h"
@@ -45,6 +50,11 @@
 
 #define NAPI_RETURN_UNDEFINED() return 0;
 
+#define NAPI_COLUMN_FAMILY_CONTEXT(obj, database)               \
+  ColumnFamily* columnFamily =                                  \
+      ColumnFamilyProperty(env, obj, "columnFamily", database); \
+  if (columnFamily == nullptr) NAPI_RETURN_UNDEFINED();
+
 #define NAPI_UTF8_NEW(name, val)                                   \
   size_t name##_size = 0;                                          \
   NAPI_STATUS_THROWS(                                              \
@@ -160,6 +170,18 @@ napi_value CreateError(napi_env env, const char* str);
 
 napi_value CreateCodeError(napi_env env, const char* code, const char* msg);
 
+/**
+ * N-API only creates `Error`, `TypeError` and `RangeError` directly
+ */
+napi_value CreateSyntaxError(napi_env env, const char* msg);
+
+/**
+ * Create an error object for a non-ok status.
+ * The error code is derived from the kind of status.
+ */
+napi_value CreateStatusError(napi_env env, const rocksdb::Status& status,
+                             const char* msg);
+
 /**
  * Returns true if 'obj' has a property 'key'.
  */
@@ -190,6 +212,21 @@ bool EncodingIsBuffer(napi_env env, napi_value options, const char* option);
 uint32_t Uint32Property(napi_env env, napi_value obj, const char* key,
                         uint32_t DEFAULT);
 
+/**
+ * Returns a uint64 property 'key' from 'obj'.
+ * Returns 'DEFAULT' if the property doesn't exist.
+ * Numbers are exact up to 2^53.
+ */
+uint64_t Uint64Property(napi_env env, napi_value obj, const char* key,
+                        uint64_t DEFAULT);
+
+/**
+ * Returns a double property 'key' from 'obj'.
+ * Returns 'DEFAULT' if the property doesn't exist.
+ */
+double DoubleProperty(napi_env env, napi_value obj, const char* key,
+                      double DEFAULT);
+
 /**
  * Returns a int32 property 'key' from 'obj'.
  * Returns 'DEFAULT' if the property doesn't exist.
@@ -216,8 +253,38 @@ const TransactionSnapshot* TransactionSnapshotProperty(napi_env env,
                                                        napi_value obj,
                                                        const char* key);
 
+/**
+ * Returns a column family property 'key' from 'obj'.
+ * Returns the default column family of `database` if the property doesn't
+ * exist.
+ * Throws and returns `nullptr` if the column family is not one of
+ * `database`.
+ */
+ColumnFamily* ColumnFamilyProperty(napi_env env, napi_value obj,
+                                   const char* key, Database* database);
+
+/**
+ * Returns the block cache of a cache property 'key' from 'obj'.
+ * Returns `nullptr` if the property doesn't exist.
+ */
+std::shared_ptr<rocksdb::Cache> CacheProperty(napi_env env, napi_value obj,
+                                              const char* key);
+
+/**
+ * Returns the write buffer manager property 'key' from 'obj'.
+ * Returns `nullptr` if the property doesn't exist.
+ */
+std::shared_ptr<rocksdb::WriteBufferManager> WriteBufferManagerProperty(
+    napi_env env, napi_value obj, const char* key);
+
 void DisposeSliceBuffer(rocksdb::Slice slice);
 
+/**
+ * Copies `size` bytes of `data` into a slice owned by the caller.
+ * This does not use N-API, the slice is freed with `DisposeSliceBuffer`.
+ */
+rocksdb::Slice CopySlice(const char* data, const size_t size);
+
 /**
  * Convert a napi_value to a rocksdb::Slice.
  */
@@ -239,6 +306,11 @@ std::string* RangeOption(napi_env env, napi_value opts, const char* name);
  */
 std::vector<rocksdb::Slice>* KeyArray(napi_env env, napi_value arr);
 
+/**
+ * Returns the indices of `keys` in ascending key order.
+ */
+std::vector<size_t> SortedKeyOrder(const std::vector<rocksdb::Slice>& keys);
+
 /**
  * Calls a function.
  */
@@ -3,36 +3,48 @@
 #include "worker.h"
 
 #include <napi-macros.h>
+#include <chrono>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
 #include <node_api.h>
+#include <rocksdb/iostats_context.h>
+#include <rocksdb/perf_context.h>
+#include <rocksdb/perf_level.h>
 #include <rocksdb/status.h>
 
 #include "database.h"
+#include "executor.h"
+#include "transaction.h"
 #include "utils.h"
 
 BaseWorker::BaseWorker(napi_env env, Database* database, napi_value callback,
                        const char* resourceName)
-    : database_(database), transaction_(nullptr), errMsg_(nullptr) {
+    : database_(database),
+      transaction_(nullptr),
+      resourceName_(resourceName),
+      perfRef_(nullptr),
+      latency_(GetWorkerLatency(resourceName)),
+      queued_(std::chrono::steady_clock::now()),
+      asyncWork_(nullptr),
+      errMsg_(nullptr) {
   NAPI_STATUS_THROWS_VOID(
       napi_create_reference(env, callback, 1, &callbackRef_));
-  napi_value asyncResourceName;
-  NAPI_STATUS_THROWS_VOID(napi_create_string_utf8(
-      env, resourceName, NAPI_AUTO_LENGTH, &asyncResourceName));
-  NAPI_STATUS_THROWS_VOID(napi_create_async_work(
-      env, callback, asyncResourceName, BaseWorker::Execute,
-      BaseWorker::Complete, this, &asyncWork_));
 }
 
 BaseWorker::BaseWorker(napi_env env, Transaction* transaction,
                        napi_value callback, const char* resourceName)
-    : database_(nullptr), transaction_(transaction), errMsg_(nullptr) {
+    : database_(nullptr),
+      transaction_(transaction),
+      resourceName_(resourceName),
+      perfRef_(nullptr),
+      latency_(GetWorkerLatency(resourceName)),
+      queued_(std::chrono::steady_clock::now()),
+      asyncWork_(nullptr),
+      errMsg_(nullptr) {
   NAPI_STATUS_THROWS_VOID(
       napi_create_reference(env, callback, 1, &callbackRef_));
-  napi_value asyncResourceName;
-  NAPI_STATUS_THROWS_VOID(napi_create_string_utf8(
-      env, resourceName, NAPI_AUTO_LENGTH, &asyncResourceName));
-  NAPI_STATUS_THROWS_VOID(napi_create_async_work(
-      env, callback, asyncResourceName, BaseWorker::Execute,
-      BaseWorker::Complete, this, &asyncWork_));
 }
 
 BaseWorker::~BaseWorker() { delete[] errMsg_; }
@@ -41,7 +53,70 @@ void BaseWorker::Execute(napi_env env, void* data) {
   BaseWorker* self = (BaseWorker*)data;
   // Don't pass env to DoExecute() because use of Node-API
   // methods should generally be avoided in async work.
-  self->DoExecute();
+  self->Run();
+}
+
+void BaseWorker::Run() {
+  const std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  latency_->queue_.Record(start - queued_);
+  if (perfRef_ == nullptr) {
+    DoExecute();
+  } else {
+    RunProfiled();
+  }
+  latency_->execute_.Record(std::chrono::steady_clock::now() - start);
+}
+
+void BaseWorker::RunProfiled() {
+  // Perf levels and contexts are thread local
+  rocksdb::SetPerfLevel(rocksdb::PerfLevel::kEnableTimeExceptForMutex);
+  rocksdb::PerfContext* perf = rocksdb::get_perf_context();
+  rocksdb::IOStatsContext* iostats = rocksdb::get_iostats_context();
+  perf->Reset();
+  iostats->Reset();
+  DoExecute();
+  rocksdb::SetPerfLevel(rocksdb::PerfLevel::kDisable);
+  perf_ = {
+      {"userKeyComparisonCount", perf->user_key_comparison_count},
+      {"blockCacheHitCount", perf->block_cache_hit_count},
+      {"blockReadCount", perf->block_read_count},
+      {"blockReadBytes", perf->block_read_byte},
+      {"blockReadNanos", perf->block_read_time},
+      {"blockChecksumNanos", perf->block_checksum_time},
+      {"blockDecompressNanos", perf->block_decompress_time},
+      {"indexBlockReadCount", perf->index_block_read_count},
+      {"filterBlockReadCount", perf->filter_block_read_count},
+      {"getSnapshotNanos", perf->get_snapshot_time},
+      {"getFromMemtableNanos", perf->get_from_memtable_time},
+      {"getFromMemtableCount", perf->get_from_memtable_count},
+      {"getFromOutputFilesNanos", perf->get_from_output_files_time},
+      {"seekOnMemtableNanos", perf->seek_on_memtable_time},
+      {"seekInternalSeekNanos", perf->seek_internal_seek_time},
+      {"findNextUserEntryNanos", perf->find_next_user_entry_time},
+      {"internalKeySkippedCount", perf->internal_key_skipped_count},
+      {"internalDeleteSkippedCount", perf->internal_delete_skipped_count},
+      {"bloomMemtableHitCount", perf->bloom_memtable_hit_count},
+      {"bloomMemtableMissCount", perf->bloom_memtable_miss_count},
+      {"bloomSstHitCount", perf->bloom_sst_hit_count},
+      {"bloomSstMissCount", perf->bloom_sst_miss_count},
+      {"getReadBytes", perf->get_read_bytes},
+      {"multiGetReadBytes", perf->multiget_read_bytes},
+      {"iterReadBytes", perf->iter_read_bytes},
+      {"bytesRead", iostats->bytes_read},
+      {"readNanos", iostats->read_nanos},
+      {"bytesWritten", iostats->bytes_written},
+      {"writeNanos", iostats->write_nanos},
+      {"fsyncNanos", iostats->fsync_nanos},
+      {"openNanos", iostats->open_nanos},
+  };
+}
+
+void BaseWorker::SetPerf(napi_env env, napi_value options) {
+  if (!HasProperty(env, options, "perf")) return;
+  napi_value perf = GetProperty(env, options, "perf");
+  if (!IsObject(env, perf)) return;
+  NAPI_STATUS_THROWS_VOID(napi_create_reference(env, perf, 1, &perfRef_));
 }
 
 bool BaseWorker::SetStatus(rocksdb::Status status) {
@@ -63,7 +138,10 @@ void BaseWorker::SetErrorMessage(const char* msg) {
 void BaseWorker::Complete(napi_env env, napi_status status, void* data) {
   BaseWorker* self = (BaseWorker*)data;
 
+  const std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
   self->DoComplete(env);
+  self->latency_->complete_.Record(std::chrono::steady_clock::now() - start);
   self->DoFinally(env);
 }
 
@@ -71,6 +149,16 @@ void BaseWorker::DoComplete(napi_env env) {
   napi_value callback;
   napi_get_reference_value(env, callbackRef_, &callback);
 
+  if (perfRef_ != nullptr) {
+    napi_value perf;
+    napi_get_reference_value(env, perfRef_, &perf);
+    for (const std::pair<const char*, uint64_t>& field : perf_) {
+      napi_value value;
+      napi_create_double(env, static_cast<double>(field.second), &value);
+      napi_set_named_property(env, perf, field.first, value);
+    }
+  }
+
   if (status_.ok()) {
     HandleOKCallback(env, callback);
   } else {
@@ -85,41 +173,58 @@ void BaseWorker::HandleOKCallback(napi_env env, napi_value callback) {
 }
 
 void BaseWorker::HandleErrorCallback(napi_env env, napi_value callback) {
-  napi_value argv;
-
-  if (status_.IsNotFound()) {
-    argv = CreateCodeError(env, "NOT_FOUND", errMsg_);
-  } else if (status_.IsCorruption()) {
-    argv = CreateCodeError(env, "CORRUPTION", errMsg_);
-  } else if (status_.IsIOError()) {
-    if (strlen(errMsg_) > 15 &&
-        strncmp("IO error: lock ", errMsg_, 15) == 0) {  // fs_posix.cc
-      argv = CreateCodeError(env, "LOCKED", errMsg_);
-    } else if (strlen(errMsg_) > 32 &&
-               strncmp("IO error: Failed to create lock ", errMsg_, 32) ==
-                   0) {  // env_win.cc
-      argv = CreateCodeError(env, "LOCKED", errMsg_);
-    } else {
-      argv = CreateCodeError(env, "IO_ERROR", errMsg_);
-    }
-  } else if (status_.IsBusy()) {
-    argv = CreateCodeError(env, "TRANSACTION_CONFLICT", errMsg_);
-  } else {
-    argv = CreateError(env, errMsg_);
-  }
-
+  napi_value argv = CreateStatusError(env, status_, errMsg_);
   CallFunction(env, callback, 1, &argv);
 }
 
 void BaseWorker::DoFinally(napi_env env) {
   napi_delete_reference(env, callbackRef_);
-  napi_delete_async_work(env, asyncWork_);
+  if (perfRef_ != nullptr) napi_delete_reference(env, perfRef_);
+  if (asyncWork_ != nullptr) napi_delete_async_work(env, asyncWork_);
   // Because the worker is executed asynchronously
   // cleanup must be done by itself
   delete this;
 }
 
-void BaseWorker::Queue(napi_env env) { napi_queue_async_work(env, asyncWork_); }
+bool BaseWorker::IsLongRunning() const { return false; }
+
+bool BaseWorker::DoExecuteFast() { return false; }
+
+void BaseWorker::QueueFast(napi_env env) {
+  // Profiled workers are always queued, so the breakdown covers all tiers
+  if (perfRef_ == nullptr) {
+    const std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+    if (DoExecuteFast()) {
+      latency_->execute_.Record(std::chrono::steady_clock::now() - start);
+      Complete(env, napi_ok, this);
+      return;
+    }
+  }
+  Queue(env);
+}
+
+void BaseWorker::Queue(napi_env env) {
+  // Workers of `destroyDb` and `repairDb` have no database
+  Database* database = database_;
+  if (database == nullptr && transaction_ != nullptr) {
+    database = transaction_->database_;
+  }
+  if (database != nullptr && database->executor_ != nullptr) {
+    database->executor_->Submit(env, this, resourceName_, IsLongRunning());
+    return;
+  }
+  napi_value callback;
+  NAPI_STATUS_THROWS_VOID(
+      napi_get_reference_value(env, callbackRef_, &callback));
+  napi_value asyncResourceName;
+  NAPI_STATUS_THROWS_VOID(napi_create_string_utf8(
+      env, resourceName_, NAPI_AUTO_LENGTH, &asyncResourceName));
+  NAPI_STATUS_THROWS_VOID(napi_create_async_work(
+      env, callback, asyncResourceName, BaseWorker::Execute,
+      BaseWorker::Complete, this, &asyncWork_));
+  napi_queue_async_work(env, asyncWork_);
+}
 
 PriorityWorker::PriorityWorker(napi_env env, Database* database,
                                napi_value callback, const char* resourceName)
@@ -144,3 +249,114 @@ void PriorityWorker::DoFinally(napi_env env) {
   }
   BaseWorker::DoFinally(env);
 }
+
+/**
+ * Replays the operations of a batch into another batch
+ * Batches only reference column families by id
+ */
+struct AppendHandler final : public rocksdb::WriteBatch::Handler {
+  AppendHandler(Database* database, rocksdb::WriteBatch* batch)
+      : database_(database), batch_(batch) {}
+
+  rocksdb::Status PutCF(uint32_t columnFamilyId, const rocksdb::Slice& key,
+                        const rocksdb::Slice& value) override {
+    rocksdb::ColumnFamilyHandle* columnFamily = Find(columnFamilyId);
+    if (columnFamily == nullptr) return MissingColumnFamily();
+    return batch_->Put(columnFamily, key, value);
+  }
+
+  rocksdb::Status DeleteCF(uint32_t columnFamilyId,
+                           const rocksdb::Slice& key) override {
+    rocksdb::ColumnFamilyHandle* columnFamily = Find(columnFamilyId);
+    if (columnFamily == nullptr) return MissingColumnFamily();
+    return batch_->Delete(columnFamily, key);
+  }
+
+ private:
+  rocksdb::ColumnFamilyHandle* Find(uint32_t columnFamilyId) const {
+    for (ColumnFamily* columnFamily : database_->allColumnFamilies_) {
+      if (columnFamily->handle_->GetID() == columnFamilyId) {
+        return columnFamily->handle_;
+      }
+    }
+    return nullptr;
+  }
+
+  static rocksdb::Status MissingColumnFamily() {
+    return rocksdb::Status::InvalidArgument("Column family not found");
+  }
+
+  Database* database_;
+  rocksdb::WriteBatch* batch_;
+};
+
+WriteWorker::WriteWorker(napi_env env, Database* database, napi_value callback,
+                         const char* resourceName, const bool sync)
+    : PriorityWorker(env, database, callback, resourceName), leader_(false) {
+  options_.sync = sync;
+}
+
+WriteWorker::~WriteWorker() = default;
+
+void WriteWorker::Queue(napi_env env) {
+  if (options_.sync) {
+    database_->QueueSyncWrite(env, this);
+  } else {
+    BaseWorker::Queue(env);
+  }
+}
+
+void WriteWorker::DoExecute() {
+  if (followers_.empty()) {
+    SetStatus(Write());
+    return;
+  }
+  // A write that cannot be appended fails on its own
+  // the rest of the group is still committed
+  std::vector<WriteWorker*> members;
+  members.reserve(followers_.size() + 1);
+  members.push_back(this);
+  members.insert(members.end(), followers_.begin(), followers_.end());
+  std::vector<WriteWorker*> appended;
+  appended.reserve(members.size());
+  rocksdb::WriteBatch batch;
+  for (WriteWorker* member : members) {
+    batch.SetSavePoint();
+    rocksdb::Status status = member->Append(&batch);
+    if (status.ok()) {
+      batch.PopSavePoint();
+      appended.push_back(member);
+    } else {
+      batch.RollbackToSavePoint();
+      member->SetStatus(status);
+    }
+  }
+  if (appended.empty()) return;
+  rocksdb::Status status = database_->WriteBatch(options_, &batch);
+  for (WriteWorker* member : appended) member->SetStatus(status);
+}
+
+void WriteWorker::DoFinally(napi_env env) {
+  if (leader_) {
+    for (WriteWorker* follower : followers_) {
+      // A throwing callback must not prevent the remaining callbacks
+      bool isExceptionPending = false;
+      napi_is_exception_pending(env, &isExceptionPending);
+      if (isExceptionPending) {
+        napi_value error;
+        napi_get_and_clear_last_exception(env, &error);
+        napi_fatal_exception(env, error);
+      }
+      BaseWorker::Complete(env, napi_ok, follower);
+    }
+    followers_.clear();
+    database_->CompleteSyncWrite(env);
+  }
+  PriorityWorker::DoFinally(env);
+}
+
+rocksdb::Status WriteWorker::AppendBatch(const rocksdb::WriteBatch& source,
+                                         rocksdb::WriteBatch* batch) {
+  AppendHandler handler(database_, batch);
+  return source.Iterate(&handler);
+}
@@ -4,14 +4,23 @@
 #define NAPI_VERSION 3
 #endif
 
+#include <chrono>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
 #include <node_api.h>
+#include <rocksdb/options.h>
 #include <rocksdb/status.h>
+#include <rocksdb/write_batch.h>
 
 #include "database.h"
+#include "latency.h"
 #include "transaction.h"
 
 /**
- * Asynchronous worker queues operations into the Node.js libuv thread pool
+ * Asynchronous worker queues operations into the database's executor, or
+ * the Node.js libuv thread pool when the database has none
  * Use this to make synchronous operations asynchronous so you don't block
  * the main Node.js thread
  *
@@ -36,6 +45,20 @@ struct BaseWorker {
 
   static void Execute(napi_env env, void* data);
 
+  /**
+   * Executes the worker on the calling thread
+   * When profiled, the perf context and IO stats context of the execution
+   * are captured
+   */
+  void Run();
+
+  /**
+   * Profiles the execution, the breakdown is written into the `perf`
+   * object of `options` before the callback is called
+   * This is a noop when `options` has no `perf` object
+   */
+  void SetPerf(napi_env env, napi_value options);
+
   bool SetStatus(rocksdb::Status status);
 
   void SetErrorMessage(const char* msg);
@@ -52,13 +75,46 @@ struct BaseWorker {
 
   virtual void DoFinally(napi_env env);
 
-  void Queue(napi_env env);
+  /**
+   * Long running workers are executed apart from point operations
+   */
+  virtual bool IsLongRunning() const;
+
+  virtual void Queue(napi_env env);
+
+  /**
+   * Attempts the work on the main thread, this must not block
+   * Returns false when the work needs the pool, such as reads that miss
+   * the block cache
+   */
+  virtual bool DoExecuteFast();
+
+  /**
+   * Completes the worker straight away when `DoExecuteFast` succeeds,
+   * otherwise queues it
+   * The callback may be called before this returns
+   */
+  void QueueFast(napi_env env);
 
   Database* database_;
   Transaction* transaction_;
 
  private:
+  void RunProfiled();
+
   napi_ref callbackRef_;
+  const char* resourceName_;
+  napi_ref perfRef_;
+  std::vector<std::pair<const char*, uint64_t>> perf_;
+  WorkerLatency* latency_;
+  /**
+   * Queue waits are measured from construction, so delayed workers such as
+   * closes and grouped writes include their delay
+   */
+  std::chrono::steady_clock::time_point queued_;
+  /**
+   * Only created when queued onto the libuv thread pool
+   */
   napi_async_work asyncWork_;
   rocksdb::Status status_;
   char* errMsg_;
@@ -79,3 +135,48 @@ struct PriorityWorker : public BaseWorker {
 
   void DoFinally(napi_env env) override;
 };
+
+/**
+ * Write worker represents writes to a database that can be group committed
+ * Synchronous writes are queued through `Database::QueueSyncWrite`, the
+ * writes queued while one is in flight are written together by the next
+ * leader with a single WAL sync
+ *
+ * Derived classes override `Write` and `Append` instead of `DoExecute`
+ */
+struct WriteWorker : public PriorityWorker {
+  WriteWorker(napi_env env, Database* database, napi_value callback,
+              const char* resourceName, const bool sync);
+
+  virtual ~WriteWorker();
+
+  void Queue(napi_env env) override;
+
+  void DoExecute() override;
+
+  void DoFinally(napi_env env) override;
+
+  /**
+   * Writes on its own
+   */
+  virtual rocksdb::Status Write() = 0;
+
+  /**
+   * Adds the write to a group `batch`
+   */
+  virtual rocksdb::Status Append(rocksdb::WriteBatch* batch) = 0;
+
+  rocksdb::WriteOptions options_;
+  /**
+   * Writes committed by this worker when it leads a group
+   */
+  std::vector<WriteWorker*> followers_;
+  bool leader_;
+
+ protected:
+  /**
+   * Copies the operations of `source` into `batch`
+   */
+  rocksdb::Status AppendBatch(const rocksdb::WriteBatch& source,
+                              rocksdb::WriteBatch* batch);
+};
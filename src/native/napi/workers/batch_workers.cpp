@@ -13,39 +13,45 @@
 BatchWorker::BatchWorker(napi_env env, Database* database, napi_value callback,
                          rocksdb::WriteBatch* batch, const bool sync,
                          const bool hasData)
-    : PriorityWorker(env, database, callback, "rocksdb.batch.do"),
+    : WriteWorker(env, database, callback, "rocksdb.batch.do", sync),
       batch_(batch),
-      hasData_(hasData) {
-  options_.sync = sync;
-}
+      hasData_(hasData) {}
 
 BatchWorker::~BatchWorker() { delete batch_; }
 
-void BatchWorker::DoExecute() {
-  if (hasData_) {
-    SetStatus(database_->WriteBatch(options_, batch_));
-  }
+rocksdb::Status BatchWorker::Write() {
+  if (!hasData_) return rocksdb::Status::OK();
+  return database_->WriteBatch(options_, batch_);
+}
+
+rocksdb::Status BatchWorker::Append(rocksdb::WriteBatch* batch) {
+  if (!hasData_) return rocksdb::Status::OK();
+  return AppendBatch(*batch_, batch);
 }
 
 BatchWriteWorker::BatchWriteWorker(napi_env env, napi_value context,
                                    Batch* batch, napi_value callback,
                                    const bool sync)
-    : PriorityWorker(env, batch->database_, callback, "rocksdb.batch.write"),
-      batch_(batch),
-      sync_(sync) {
+    : WriteWorker(env, batch->database_, callback, "rocksdb.batch.write",
+                  sync),
+      batch_(batch) {
   // Prevent GC of batch object before we execute
   NAPI_STATUS_THROWS_VOID(napi_create_reference(env, context, 1, &contextRef_));
 }
 
 BatchWriteWorker::~BatchWriteWorker() {}
 
-void BatchWriteWorker::DoExecute() {
-  if (batch_->hasData_) {
-    SetStatus(batch_->Write(sync_));
-  }
+rocksdb::Status BatchWriteWorker::Write() {
+  if (!batch_->hasData_) return rocksdb::Status::OK();
+  return batch_->Write(options_.sync);
+}
+
+rocksdb::Status BatchWriteWorker::Append(rocksdb::WriteBatch* batch) {
+  if (!batch_->hasData_) return rocksdb::Status::OK();
+  return AppendBatch(*batch_->batch_, batch);
 }
 
 void BatchWriteWorker::DoFinally(napi_env env) {
   napi_delete_reference(env, contextRef_);
-  PriorityWorker::DoFinally(env);
+  WriteWorker::DoFinally(env);
 }
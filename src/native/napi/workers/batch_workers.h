@@ -15,16 +15,17 @@
 /**
  * Worker class for batch write operation.
  */
-struct BatchWorker final : public PriorityWorker {
+struct BatchWorker final : public WriteWorker {
   BatchWorker(napi_env env, Database* database, napi_value callback,
               rocksdb::WriteBatch* batch, const bool sync, const bool hasData);
 
   ~BatchWorker();
 
-  void DoExecute() override;
+  rocksdb::Status Write() override;
+
+  rocksdb::Status Append(rocksdb::WriteBatch* batch) override;
 
  private:
-  rocksdb::WriteOptions options_;
   rocksdb::WriteBatch* batch_;
   const bool hasData_;
 };
@@ -32,18 +33,19 @@ struct BatchWorker final : public PriorityWorker {
 /**
  * Worker class for batch write operation.
  */
-struct BatchWriteWorker final : public PriorityWorker {
+struct BatchWriteWorker final : public WriteWorker {
   BatchWriteWorker(napi_env env, napi_value context, Batch* batch,
                    napi_value callback, const bool sync);
 
   ~BatchWriteWorker();
 
-  void DoExecute() override;
+  rocksdb::Status Write() override;
+
+  rocksdb::Status Append(rocksdb::WriteBatch* batch) override;
 
   void DoFinally(napi_env env) override;
 
  private:
   Batch* batch_;
-  const bool sync_;
   napi_ref contextRef_;
 };
@@ -4,7 +4,9 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <string>
+#include <utility>
 
 #include <node_api.h>
 #include <rocksdb/env.h>
@@ -14,57 +16,137 @@
 #include <rocksdb/options.h>
 #include <rocksdb/table.h>
 #include <rocksdb/write_batch.h>
+#include <rocksdb/write_buffer_manager.h>
 #include <rocksdb/filter_policy.h>
+#include <rocksdb/slice_transform.h>
 
 #include "../worker.h"
 #include "../database.h"
+#include "../keypath.h"
 #include "../snapshot.h"
 #include "../utils.h"
 
+void SetColumnFamilyOptions(
+    rocksdb::ColumnFamilyOptions& options, const ColumnFamilyConfig& config,
+    const std::shared_ptr<rocksdb::Cache>& blockCache) {
+  options.compression = config.compression_;
+  options.compression_per_level = config.compressionPerLevel_;
+  options.bottommost_compression = config.bottommostCompression_;
+  options.compression_opts.level = config.compressionLevel_;
+  options.compression_opts.max_dict_bytes = config.compressionDictBytes_;
+  options.compression_opts.zstd_max_train_bytes =
+      config.compressionDictTrainBytes_;
+  options.write_buffer_size = config.writeBufferSize_;
+  options.max_write_buffer_number = config.maxWriteBufferNumber_;
+  options.min_write_buffer_number_to_merge =
+      config.minWriteBufferNumberToMerge_;
+  options.enable_blob_files = config.enableBlobFiles_;
+  options.min_blob_size = config.minBlobSize_;
+  options.blob_file_size = config.blobFileSize_;
+  options.blob_compression_type = config.blobCompression_;
+  options.enable_blob_garbage_collection = config.enableBlobGarbageCollection_;
+  options.blob_garbage_collection_age_cutoff =
+      config.blobGarbageCollectionAgeCutoff_;
+  if (config.prefixLevels_) {
+    options.prefix_extractor.reset(NewLevelPathTransform(config.prefixLevels_));
+    options.memtable_prefix_bloom_size_ratio = 0.1;
+  } else {
+    options.prefix_extractor.reset();
+  }
+
+  rocksdb::BlockBasedTableOptions tableOptions;
+
+  if (blockCache) {
+    tableOptions.block_cache = blockCache;
+  } else {
+    tableOptions.no_block_cache = true;
+  }
+
+  tableOptions.block_size = config.blockSize_;
+  tableOptions.block_restart_interval = config.blockRestartInterval_;
+  tableOptions.format_version = config.formatVersion_;
+  if (config.filterBitsPerKey_ && config.ribbonFilter_) {
+    // Tables before format version 5 get bloom filters instead
+    tableOptions.filter_policy.reset(
+        rocksdb::NewExperimentalRibbonFilterPolicy(config.filterBitsPerKey_));
+  } else if (config.filterBitsPerKey_) {
+    tableOptions.filter_policy.reset(
+        rocksdb::NewBloomFilterPolicy(config.filterBitsPerKey_, false));
+  }
+  if (config.partitionedIndexFilters_) {
+    tableOptions.index_type =
+        rocksdb::BlockBasedTableOptions::kTwoLevelIndexSearch;
+    tableOptions.partition_filters = config.filterBitsPerKey_ > 0;
+  }
+  if (config.cacheIndexAndFilterBlocks_ && blockCache) {
+    tableOptions.cache_index_and_filter_blocks = true;
+    tableOptions.cache_index_and_filter_blocks_with_high_priority = true;
+    tableOptions.pin_top_level_index_and_filter = true;
+    tableOptions.pin_l0_filter_and_index_blocks_in_cache =
+        config.pinL0FilterAndIndexBlocks_;
+  }
+  if (config.dataBlockHashIndex_) {
+    tableOptions.data_block_index_type =
+        rocksdb::BlockBasedTableOptions::kDataBlockBinaryAndHash;
+  }
+
+  options.table_factory.reset(
+      rocksdb::NewBlockBasedTableFactory(tableOptions));
+}
+
 OpenWorker::OpenWorker(napi_env env, Database* database, napi_value callback,
                        const std::string& location, const bool createIfMissing,
-                       const bool errorIfExists, const bool compression,
-                       const uint32_t writeBufferSize, const uint32_t blockSize,
-                       const uint32_t maxOpenFiles,
-                       const uint32_t blockRestartInterval,
-                       const uint32_t maxFileSize, const uint32_t cacheSize,
+                       const bool errorIfExists, const uint32_t maxOpenFiles,
+                       const uint64_t maxFileSize,
+                       std::shared_ptr<rocksdb::Cache> blockCache,
+                       std::shared_ptr<rocksdb::WriteBufferManager>
+                           writeBufferManager,
+                       const bool pipelinedWrite,
+                       const bool concurrentMemtableWrite,
+                       const bool statistics,
+                       const ColumnFamilyConfig& defaults,
+                       const std::vector<ColumnFamilyConfig>& columnFamilies,
                        const rocksdb::InfoLogLevel log_level,
                        rocksdb::Logger* logger)
     : BaseWorker(env, database, callback, "rocksdb.db.open"),
       location_(location) {
   options_.create_if_missing = createIfMissing;
+  options_.create_missing_column_families = true;
   options_.error_if_exists = errorIfExists;
-  options_.compression =
-      compression ? rocksdb::kSnappyCompression : rocksdb::kNoCompression;
-  options_.write_buffer_size = writeBufferSize;
   options_.max_open_files = maxOpenFiles;
   options_.max_log_file_size = maxFileSize;
   options_.paranoid_checks = false;
   options_.info_log_level = log_level;
+  options_.enable_pipelined_write = pipelinedWrite;
+  options_.allow_concurrent_memtable_write = concurrentMemtableWrite;
+  options_.write_buffer_manager = std::move(writeBufferManager);
   if (logger) {
     options_.info_log.reset(logger);
   }
 
-  rocksdb::BlockBasedTableOptions tableOptions;
+  database->blockCache_ = blockCache;
 
-  if (cacheSize) {
-    tableOptions.block_cache = rocksdb::NewLRUCache(cacheSize);
+  if (statistics) {
+    database->statistics_ = rocksdb::CreateDBStatistics();
+    options_.statistics = database->statistics_;
   } else {
-    tableOptions.no_block_cache = true;
+    database->statistics_.reset();
   }
 
-  tableOptions.block_size = blockSize;
-  tableOptions.block_restart_interval = blockRestartInterval;
-  tableOptions.filter_policy.reset(rocksdb::NewBloomFilterPolicy(10));
-
-  options_.table_factory.reset(
-      rocksdb::NewBlockBasedTableFactory(tableOptions));
+  SetColumnFamilyOptions(options_, defaults, database->blockCache_);
+  for (const ColumnFamilyConfig& config : columnFamilies) {
+    rocksdb::ColumnFamilyOptions columnFamilyOptions(options_);
+    SetColumnFamilyOptions(columnFamilyOptions, config, database->blockCache_);
+    columnFamilies_.emplace_back(config.name_, columnFamilyOptions);
+  }
 }
 
 OpenWorker::~OpenWorker() {}
 
+bool OpenWorker::IsLongRunning() const { return true; }
+
 void OpenWorker::DoExecute() {
-  SetStatus(database_->Open(options_, location_.c_str()));
+  SetStatus(database_->Open(options_, location_.c_str(), columnFamilies_));
 }
 
 CloseWorker::CloseWorker(napi_env env, Database* database, napi_value callback)
@@ -72,68 +154,101 @@ CloseWorker::CloseWorker(napi_env env, Database* database, napi_value callback)
 
 CloseWorker::~CloseWorker() {}
 
+bool CloseWorker::IsLongRunning() const { return true; }
+
 void CloseWorker::DoExecute() { database_->Close(); }
 
 void CloseWorker::DoFinally(napi_env env) {
+  database_->StopExecutor();
   database_->Detach(env);
   BaseWorker::DoFinally(env);
 }
 
-GetWorker::GetWorker(napi_env env, Database* database, napi_value callback,
+GetWorker::GetWorker(napi_env env, Database* database,
+                     ColumnFamily* columnFamily, napi_value callback,
                      rocksdb::Slice key, const bool asBuffer,
                      const bool fillCache, const Snapshot* snapshot)
     : PriorityWorker(env, database, callback, "rocksdb.db.get"),
+      columnFamily_(columnFamily),
       key_(key),
+      value_(new PinnedValue(database->blockCache_)),
       asBuffer_(asBuffer) {
   options_.fill_cache = fillCache;
   if (snapshot) options_.snapshot = snapshot->snapshot();
 }
 
-GetWorker::~GetWorker() { DisposeSliceBuffer(key_); }
+GetWorker::~GetWorker() {
+  DisposeSliceBuffer(key_);
+  delete value_;
+}
 
 void GetWorker::DoExecute() {
-  SetStatus(database_->Get(options_, key_, value_));
+  SetStatus(database_->Get(options_, columnFamily_->handle_, key_,
+                           &value_->slice_));
+}
+
+bool GetWorker::DoExecuteFast() {
+  options_.read_tier = rocksdb::kBlockCacheTier;
+  rocksdb::Status status =
+      database_->Get(options_, columnFamily_->handle_, key_, &value_->slice_);
+  options_.read_tier = rocksdb::kReadAllTier;
+  // Incomplete means the value may be in a block that is not cached
+  if (status.IsIncomplete()) {
+    value_->slice_.Reset();
+    return false;
+  }
+  SetStatus(status);
+  return true;
 }
 
 void GetWorker::HandleOKCallback(napi_env env, napi_value callback) {
   napi_value argv[2];
   napi_get_null(env, &argv[0]);
-  Entry::Convert(env, &value_, asBuffer_, &argv[1]);
+  Entry::ConvertPinned(env, value_, asBuffer_, &argv[1]);
+  value_ = nullptr;
   CallFunction(env, callback, 2, argv);
 }
 
 MultiGetWorker::MultiGetWorker(napi_env env, Database* database,
+                               ColumnFamily* columnFamily,
                                const std::vector<rocksdb::Slice>* keys,
                                napi_value callback, const bool valueAsBuffer,
                                const bool fillCache, const Snapshot* snapshot)
     : PriorityWorker(env, database, callback, "rocksdb.db.multiget"),
+      columnFamily_(columnFamily),
       keys_(keys),
       valueAsBuffer_(valueAsBuffer) {
   options_.fill_cache = fillCache;
   if (snapshot) options_.snapshot = snapshot->snapshot();
 }
 
-MultiGetWorker::~MultiGetWorker() { delete keys_; }
+MultiGetWorker::~MultiGetWorker() {
+  for (const rocksdb::Slice& key : *keys_) DisposeSliceBuffer(key);
+  delete keys_;
+  for (PinnedValue* value : values_) delete value;
+}
 
 void MultiGetWorker::DoExecute() {
-  // NAPI requires a vector of string pointers
-  // the nullptr can be used to represent `undefined`
-  values_.reserve(keys_->size());
-  // RocksDB requires just a vector of strings
-  // these will be automatically deallocated
-  std::vector<std::string> values(keys_->size());
-  std::vector<rocksdb::Status> statuses =
-      database_->MultiGet(options_, *keys_, values);
-  for (size_t i = 0; i != statuses.size(); i++) {
+  // Batched lookups require the keys in ascending order
+  const std::vector<size_t> order = SortedKeyOrder(*keys_);
+  const size_t size = order.size();
+  std::vector<rocksdb::Slice> keys;
+  keys.reserve(size);
+  for (size_t i = 0; i < size; i++) {
+    keys.push_back((*keys_)[order[i]]);
+  }
+  std::vector<rocksdb::PinnableSlice> values(size);
+  std::vector<rocksdb::Status> statuses(size);
+  database_->MultiGet(options_, columnFamily_->handle_, size, keys.data(),
+                      values.data(), statuses.data(), true);
+  // The nullptr is used to represent `undefined`
+  values_.assign(size, nullptr);
+  for (size_t i = 0; i < size; i++) {
     if (statuses[i].ok()) {
-      std::string* value = new std::string(values[i]);
-      values_.push_back(value);
-    } else if (statuses[i].IsNotFound()) {
-      values_.push_back(nullptr);
-    } else {
-      for (const std::string* value : values_) {
-        if (value != NULL) delete value;
-      }
+      PinnedValue* value = new PinnedValue(database_->blockCache_);
+      value->slice_ = std::move(values[i]);
+      values_[order[i]] = value;
+    } else if (!statuses[i].IsNotFound()) {
       SetStatus(statuses[i]);
       break;
     }
@@ -146,11 +261,14 @@ void MultiGetWorker::HandleOKCallback(napi_env env, napi_value callback) {
   napi_create_array_with_length(env, size, &array);
 
   for (size_t idx = 0; idx < size; idx++) {
-    std::string* value = values_[idx];
     napi_value element;
-    Entry::Convert(env, value, valueAsBuffer_, &element);
+    if (values_[idx] == nullptr) {
+      napi_get_undefined(env, &element);
+    } else {
+      Entry::ConvertPinned(env, values_[idx], valueAsBuffer_, &element);
+      values_[idx] = nullptr;
+    }
     napi_set_element(env, array, static_cast<uint32_t>(idx), element);
-    if (value != nullptr) delete value;
   }
 
   napi_value argv[2];
@@ -159,32 +277,43 @@ void MultiGetWorker::HandleOKCallback(napi_env env, napi_value callback) {
   CallFunction(env, callback, 2, argv);
 }
 
-PutWorker::PutWorker(napi_env env, Database* database, napi_value callback,
+PutWorker::PutWorker(napi_env env, Database* database,
+                     ColumnFamily* columnFamily, napi_value callback,
                      rocksdb::Slice key, rocksdb::Slice value, bool sync)
-    : PriorityWorker(env, database, callback, "rocksdb.db.put"),
+    : WriteWorker(env, database, callback, "rocksdb.db.put", sync),
+      columnFamily_(columnFamily),
       key_(key),
-      value_(value) {
-  options_.sync = sync;
-}
+      value_(value) {}
 
 PutWorker::~PutWorker() {
   DisposeSliceBuffer(key_);
   DisposeSliceBuffer(value_);
 }
 
-void PutWorker::DoExecute() {
-  SetStatus(database_->Put(options_, key_, value_));
+rocksdb::Status PutWorker::Write() {
+  return database_->Put(options_, columnFamily_->handle_, key_, value_);
 }
 
-DelWorker::DelWorker(napi_env env, Database* database, napi_value callback,
-                     rocksdb::Slice key, bool sync)
-    : PriorityWorker(env, database, callback, "rocksdb.db.del"), key_(key) {
-  options_.sync = sync;
+rocksdb::Status PutWorker::Append(rocksdb::WriteBatch* batch) {
+  return batch->Put(columnFamily_->handle_, key_, value_);
 }
 
+DelWorker::DelWorker(napi_env env, Database* database,
+                     ColumnFamily* columnFamily, napi_value callback,
+                     rocksdb::Slice key, bool sync)
+    : WriteWorker(env, database, callback, "rocksdb.db.del", sync),
+      columnFamily_(columnFamily),
+      key_(key) {}
+
 DelWorker::~DelWorker() { DisposeSliceBuffer(key_); }
 
-void DelWorker::DoExecute() { SetStatus(database_->Del(options_, key_)); }
+rocksdb::Status DelWorker::Write() {
+  return database_->Del(options_, columnFamily_->handle_, key_);
+}
+
+rocksdb::Status DelWorker::Append(rocksdb::WriteBatch* batch) {
+  return batch->Delete(columnFamily_->handle_, key_);
+}
 
 ApproximateSizeWorker::ApproximateSizeWorker(napi_env env, Database* database,
                                              napi_value callback,
@@ -224,10 +353,28 @@ CompactRangeWorker::~CompactRangeWorker() {
   DisposeSliceBuffer(end_);
 }
 
+bool CompactRangeWorker::IsLongRunning() const { return true; }
+
 void CompactRangeWorker::DoExecute() {
   database_->CompactRange(&start_, &end_);
 }
 
+DropColumnFamilyWorker::DropColumnFamilyWorker(napi_env env,
+                                               Database* database,
+                                               ColumnFamily* columnFamily,
+                                               napi_value callback)
+    : PriorityWorker(env, database, callback,
+                     "rocksdb.db.drop_column_family"),
+      columnFamily_(columnFamily) {}
+
+DropColumnFamilyWorker::~DropColumnFamilyWorker() {}
+
+bool DropColumnFamilyWorker::IsLongRunning() const { return true; }
+
+void DropColumnFamilyWorker::DoExecute() {
+  SetStatus(database_->DropColumnFamily(columnFamily_));
+}
+
 DestroyWorker::DestroyWorker(napi_env env, const std::string& location,
                              napi_value callback)
     : BaseWorker(env, (Database*)nullptr, callback, "rocksdb.destroyDb"),
@@ -5,35 +5,63 @@
 #endif
 
 #include <cstdint>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include <node_api.h>
+#include <rocksdb/cache.h>
 #include <rocksdb/env.h>
 #include <rocksdb/options.h>
 #include <rocksdb/slice.h>
+#include <rocksdb/write_buffer_manager.h>
 
 #include "../worker.h"
 #include "../database.h"
+#include "../iterator.h"
 #include "../snapshot.h"
 
+/**
+ * Sets the options of a column family from its config
+ * Column families share the block cache but have their own table factory
+ * and prefix extractor
+ */
+void SetColumnFamilyOptions(rocksdb::ColumnFamilyOptions& options,
+                            const ColumnFamilyConfig& config,
+                            const std::shared_ptr<rocksdb::Cache>& blockCache);
+
 /**
  * Worker class for opening a database.
  * TODO: shouldn't this be a PriorityWorker?
  */
 struct OpenWorker final : public BaseWorker {
+  /**
+   * `defaults` applies to the default column family, `columnFamilies` are
+   * created when missing
+   * `blockCache` may be shared with other databases, without it blocks are
+   * not cached
+   * `writeBufferManager` may be shared with other databases, it limits the
+   * memory of the memtables of all of them
+   */
   OpenWorker(napi_env env, Database* database, napi_value callback,
              const std::string& location, const bool createIfMissing,
-             const bool errorIfExists, const bool compression,
-             const uint32_t writeBufferSize, const uint32_t blockSize,
-             const uint32_t maxOpenFiles, const uint32_t blockRestartInterval,
-             const uint32_t maxFileSize, const uint32_t cacheSize,
+             const bool errorIfExists, const uint32_t maxOpenFiles,
+             const uint64_t maxFileSize,
+             std::shared_ptr<rocksdb::Cache> blockCache,
+             std::shared_ptr<rocksdb::WriteBufferManager> writeBufferManager,
+             const bool pipelinedWrite, const bool concurrentMemtableWrite,
+             const bool statistics, const ColumnFamilyConfig& defaults,
+             const std::vector<ColumnFamilyConfig>& columnFamilies,
              const rocksdb::InfoLogLevel log_level, rocksdb::Logger* logger);
 
   ~OpenWorker();
 
   void DoExecute() override;
 
+  bool IsLongRunning() const override;
+
   rocksdb::Options options_;
+  std::vector<rocksdb::ColumnFamilyDescriptor> columnFamilies_;
   std::string location_;
 };
 
@@ -47,6 +75,8 @@ struct CloseWorker final : public BaseWorker {
 
   void DoExecute() override;
 
+  bool IsLongRunning() const override;
+
   void DoFinally(napi_env env) override;
 };
 
@@ -54,20 +84,26 @@ struct CloseWorker final : public BaseWorker {
  * Worker class for getting a value from a database.
  */
 struct GetWorker final : public PriorityWorker {
-  GetWorker(napi_env env, Database* database, napi_value callback,
-            rocksdb::Slice key, const bool asBuffer, const bool fillCache,
-            const Snapshot* snapshot = nullptr);
+  GetWorker(napi_env env, Database* database, ColumnFamily* columnFamily,
+            napi_value callback, rocksdb::Slice key, const bool asBuffer,
+            const bool fillCache, const Snapshot* snapshot = nullptr);
 
   ~GetWorker();
 
   void DoExecute() override;
 
+  /**
+   * Reads from the memtables and the block cache only
+   */
+  bool DoExecuteFast() override;
+
   void HandleOKCallback(napi_env env, napi_value callback) override;
 
  private:
   rocksdb::ReadOptions options_;
+  ColumnFamily* columnFamily_;
   rocksdb::Slice key_;
-  std::string value_;
+  PinnedValue* value_;
   const bool asBuffer_;
 };
 
@@ -75,7 +111,7 @@ struct GetWorker final : public PriorityWorker {
  * Worker class for getting many values.
  */
 struct MultiGetWorker final : public PriorityWorker {
-  MultiGetWorker(napi_env env, Database* database,
+  MultiGetWorker(napi_env env, Database* database, ColumnFamily* columnFamily,
                  const std::vector<rocksdb::Slice>* keys, napi_value callback,
                  const bool valueAsBuffer, const bool fillCache,
                  const Snapshot* snapshot = nullptr);
@@ -88,23 +124,27 @@ struct MultiGetWorker final : public PriorityWorker {
 
  private:
   rocksdb::ReadOptions options_;
+  ColumnFamily* columnFamily_;
   const std::vector<rocksdb::Slice>* keys_;
-  std::vector<std::string*> values_;
+  std::vector<PinnedValue*> values_;
   const bool valueAsBuffer_;
 };
 
 /**
  * Worker class for putting key/value to the database
  */
-struct PutWorker final : public PriorityWorker {
-  PutWorker(napi_env env, Database* database, napi_value callback,
-            rocksdb::Slice key, rocksdb::Slice value, bool sync);
+struct PutWorker final : public WriteWorker {
+  PutWorker(napi_env env, Database* database, ColumnFamily* columnFamily,
+            napi_value callback, rocksdb::Slice key, rocksdb::Slice value,
+            bool sync);
 
   ~PutWorker();
 
-  void DoExecute() override;
+  rocksdb::Status Write() override;
+
+  rocksdb::Status Append(rocksdb::WriteBatch* batch) override;
 
-  rocksdb::WriteOptions options_;
+  ColumnFamily* columnFamily_;
   rocksdb::Slice key_;
   rocksdb::Slice value_;
 };
@@ -112,15 +152,17 @@ struct PutWorker final : public PriorityWorker {
 /**
  * Worker class for deleting a value from a database.
  */
-struct DelWorker final : public PriorityWorker {
-  DelWorker(napi_env env, Database* database, napi_value callback,
-            rocksdb::Slice key, bool sync);
+struct DelWorker final : public WriteWorker {
+  DelWorker(napi_env env, Database* database, ColumnFamily* columnFamily,
+            napi_value callback, rocksdb::Slice key, bool sync);
 
   ~DelWorker();
 
-  void DoExecute() override;
+  rocksdb::Status Write() override;
+
+  rocksdb::Status Append(rocksdb::WriteBatch* batch) override;
 
-  rocksdb::WriteOptions options_;
+  ColumnFamily* columnFamily_;
   rocksdb::Slice key_;
 };
 
@@ -153,10 +195,28 @@ struct CompactRangeWorker final : public PriorityWorker {
 
   void DoExecute() override;
 
+  bool IsLongRunning() const override;
+
   rocksdb::Slice start_;
   rocksdb::Slice end_;
 };
 
+/**
+ * Worker class for dropping a column family.
+ */
+struct DropColumnFamilyWorker final : public PriorityWorker {
+  DropColumnFamilyWorker(napi_env env, Database* database,
+                         ColumnFamily* columnFamily, napi_value callback);
+
+  ~DropColumnFamilyWorker();
+
+  void DoExecute() override;
+
+  bool IsLongRunning() const override;
+
+  ColumnFamily* columnFamily_;
+};
+
 /**
  * Worker class for destroying a database.
  */
@@ -2,11 +2,15 @@
 
 #include "iterator_workers.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <cassert>
+#include <string>
 
 #include <node_api.h>
+#include <rocksdb/db.h>
+#include <rocksdb/write_batch.h>
 
 #include "../worker.h"
 #include "../iterator.h"
@@ -27,10 +31,12 @@ void IteratorCloseWorker::DoFinally(napi_env env) {
 }
 
 IteratorNextWorker::IteratorNextWorker(napi_env env, Iterator* iterator,
-                                       uint32_t size, napi_value callback)
+                                       uint32_t size, napi_value callback,
+                                       const bool packed)
     : BaseWorker(env, iterator->database_, callback, "rocksdb.iterator.next"),
       iterator_(iterator),
       size_(size),
+      packed_(packed),
       ok_() {}
 
 IteratorNextWorker::~IteratorNextWorker() {}
@@ -40,14 +46,23 @@ void IteratorNextWorker::DoExecute() {
     iterator_->SeekToRange();
   }
 
-  ok_ = iterator_->ReadMany(size_);
+  ok_ = iterator_->ReadMany(size_, packed_);
 
   if (!ok_) {
-    SetStatus(iterator_->Status());
+    SetStatus(iterator_->readStatus_.ok() ? iterator_->Status()
+                                          : iterator_->readStatus_);
   }
 }
 
 void IteratorNextWorker::HandleOKCallback(napi_env env, napi_value callback) {
+  if (packed_) {
+    napi_value argv[4];
+    napi_get_null(env, &argv[0]);
+    iterator_->ConvertPacked(env, &argv[1], &argv[2]);
+    napi_get_boolean(env, !ok_, &argv[3]);
+    CallFunction(env, callback, 4, argv);
+    return;
+  }
   size_t size = iterator_->cache_.size();
   napi_value jsArray;
   napi_create_array_with_length(env, size, &jsArray);
@@ -73,7 +88,85 @@ void IteratorNextWorker::DoFinally(napi_env env) {
   // clean up & handle the next/close state
   iterator_->nexting_ = false;
 
-  if (iterator_->closeWorker_ != NULL) {
+  if (packed_ && ok_ && iterator_->prefetch_) {
+    IteratorPrefetchWorker::Start(env, iterator_);
+  }
+
+  if (iterator_->closeWorker_ != NULL && !iterator_->nexting_) {
+    iterator_->closeWorker_->Queue(env);
+    iterator_->closeWorker_ = NULL;
+  }
+
+  BaseWorker::DoFinally(env);
+}
+
+IteratorPrefetchWorker::IteratorPrefetchWorker(napi_env env,
+                                               Iterator* iterator,
+                                               napi_value callback)
+    : BaseWorker(env, iterator->database_, callback,
+                 "rocksdb.iterator.prefetch"),
+      iterator_(iterator) {}
+
+IteratorPrefetchWorker::~IteratorPrefetchWorker() {}
+
+void IteratorPrefetchWorker::DoExecute() {
+  iterator_->prefetchStatus_ = rocksdb::Status::OK();
+  if (!iterator_->DidSeek()) {
+    iterator_->SeekToRange();
+  }
+  // Results stay on the iterator until they are delivered
+  iterator_->prefetchMore_ =
+      iterator_->ReadMany(iterator_->prefetchSize_, true);
+  if (!iterator_->prefetchMore_) {
+    iterator_->prefetchStatus_ = iterator_->readStatus_.ok()
+                                     ? iterator_->Status()
+                                     : iterator_->readStatus_;
+  }
+}
+
+void IteratorPrefetchWorker::HandleOKCallback(napi_env env,
+                                              napi_value callback) {}
+
+void IteratorPrefetchWorker::DoFinally(napi_env env) {
+  iterator_->prefetching_ = false;
+  iterator_->prefetched_ = true;
+  iterator_->nexting_ = false;
+
+  if (iterator_->seekPending_) {
+    // The prefetched batch or error is from before the seek
+    iterator_->prefetched_ = false;
+    iterator_->prefetchMore_ = false;
+    iterator_->prefetchStatus_ = rocksdb::Status::OK();
+    iterator_->packedData_.clear();
+    iterator_->packedOffsets_.clear();
+    iterator_->seekPending_ = false;
+    if (!iterator_->isClosing_ && !iterator_->hasClosed_) {
+      rocksdb::Slice target(iterator_->seekTarget_);
+      iterator_->first_ = true;
+      iterator_->Seek(target);
+    }
+  }
+
+  if (iterator_->prefetchCallback_ != nullptr) {
+    napi_value callback;
+    napi_get_reference_value(env, iterator_->prefetchCallback_, &callback);
+    napi_delete_reference(env, iterator_->prefetchCallback_);
+    iterator_->prefetchCallback_ = nullptr;
+    if (iterator_->prefetched_) {
+      Deliver(env, iterator_, callback);
+    } else if (!iterator_->isClosing_ && !iterator_->hasClosed_) {
+      IteratorNextWorker* worker = new IteratorNextWorker(
+          env, iterator_, iterator_->prefetchSize_, callback, true);
+      iterator_->nexting_ = true;
+      worker->Queue(env);
+    } else {
+      napi_value argv =
+          CreateCodeError(env, "ITERATOR_NOT_OPEN", "Iterator is not open");
+      CallFunction(env, callback, 1, &argv);
+    }
+  }
+
+  if (iterator_->closeWorker_ != NULL && !iterator_->nexting_) {
     iterator_->closeWorker_->Queue(env);
     iterator_->closeWorker_ = NULL;
   }
@@ -81,27 +174,61 @@ void IteratorNextWorker::DoFinally(napi_env env) {
   BaseWorker::DoFinally(env);
 }
 
+void IteratorPrefetchWorker::Start(napi_env env, Iterator* iterator) {
+  if (iterator->isClosing_ || iterator->hasClosed_) return;
+  napi_value noop;
+  napi_create_function(env, NULL, 0, noop_callback, NULL, &noop);
+  IteratorPrefetchWorker* worker =
+      new IteratorPrefetchWorker(env, iterator, noop);
+  iterator->prefetching_ = true;
+  iterator->nexting_ = true;
+  worker->Queue(env);
+}
+
+void IteratorPrefetchWorker::Deliver(napi_env env, Iterator* iterator,
+                                     napi_value callback) {
+  iterator->prefetched_ = false;
+  if (!iterator->prefetchStatus_.ok()) {
+    napi_value argv = CreateStatusError(
+        env, iterator->prefetchStatus_,
+        iterator->prefetchStatus_.ToString().c_str());
+    iterator->prefetchStatus_ = rocksdb::Status::OK();
+    CallFunction(env, callback, 1, &argv);
+    return;
+  }
+  napi_value argv[4];
+  napi_get_null(env, &argv[0]);
+  iterator->ConvertPacked(env, &argv[1], &argv[2]);
+  napi_get_boolean(env, !iterator->prefetchMore_, &argv[3]);
+  if (iterator->prefetchMore_) Start(env, iterator);
+  CallFunction(env, callback, 4, argv);
+}
+
 IteratorClearWorker::IteratorClearWorker(napi_env env, Database* database,
+                                         ColumnFamily* columnFamily,
                                          napi_value callback, const int limit,
                                          std::string* lt, std::string* lte,
                                          std::string* gt, std::string* gte,
                                          const bool sync,
                                          const Snapshot* snapshot)
-    : PriorityWorker(env, database, callback, "rocksdb.iterator.clear") {
-  iterator_ = new BaseIterator(database, false, lt, lte, gt, gte, limit, false,
-                               snapshot);
+    : PriorityWorker(env, database, callback, "rocksdb.iterator.clear"),
+      deleteRange_(limit < 0 && snapshot == nullptr) {
+  iterator_ = new BaseIterator(database, columnFamily, false, lt, lte, gt, gte,
+                               limit, false, snapshot);
   writeOptions_ = new rocksdb::WriteOptions();
   writeOptions_->sync = sync;
 }
 
 IteratorClearWorker::IteratorClearWorker(napi_env env, Transaction* transaction,
+                                         ColumnFamily* columnFamily,
                                          napi_value callback, const int limit,
                                          std::string* lt, std::string* lte,
                                          std::string* gt, std::string* gte,
                                          const TransactionSnapshot* snapshot)
-    : PriorityWorker(env, transaction, callback, "rocksdb.iterator.clear") {
-  iterator_ = new BaseIterator(transaction, false, lt, lte, gt, gte, limit,
-                               false, snapshot);
+    : PriorityWorker(env, transaction, callback, "rocksdb.iterator.clear"),
+      deleteRange_(false) {
+  iterator_ = new BaseIterator(transaction, columnFamily, false, lt, lte, gt,
+                               gte, limit, false, snapshot);
   writeOptions_ = nullptr;
 }
 
@@ -110,8 +237,26 @@ IteratorClearWorker::~IteratorClearWorker() {
   delete writeOptions_;
 }
 
+bool IteratorClearWorker::IsLongRunning() const { return true; }
+
 void IteratorClearWorker::DoExecute() {
   assert(database_ != nullptr || transaction_ != nullptr);
+  if (deleteRange_) {
+    std::string start;
+    std::string end;
+    if (iterator_->Bounds(&start, &end)) {
+      rocksdb::WriteBatch batch;
+      if (SetStatus(batch.DeleteRange(iterator_->columnFamily_->handle_, start,
+                                      end)) &&
+          SetStatus(database_->WriteBatch(*writeOptions_, &batch))) {
+        database_->RangeDeleted(iterator_->columnFamily_);
+      }
+    } else {
+      SetStatus(iterator_->Status());
+    }
+    iterator_->Close();
+    return;
+  }
   iterator_->SeekToRange();
   uint32_t hwm = 16 * 1024;
   if (database_ != nullptr) {
@@ -121,7 +266,10 @@ void IteratorClearWorker::DoExecute() {
       while (bytesRead <= hwm && iterator_->Valid() && iterator_->Increment()) {
         rocksdb::Slice key = iterator_->CurrentKey();
         // If this fails, we return
-        if (!SetStatus(batch.Delete(key))) return;
+        if (!SetStatus(
+                batch.Delete(iterator_->columnFamily_->handle_, key))) {
+          return;
+        }
         bytesRead += key.size();
         iterator_->Next();
       }
@@ -139,7 +287,10 @@ void IteratorClearWorker::DoExecute() {
       while (bytesRead <= hwm && iterator_->Valid() && iterator_->Increment()) {
         rocksdb::Slice key = iterator_->CurrentKey();
         // If this fails, we return
-        if (!SetStatus(transaction_->Del(key))) return;
+        if (!SetStatus(
+                transaction_->Del(iterator_->columnFamily_->handle_, key))) {
+          return;
+        }
         bytesRead += key.size();
         iterator_->Next();
       }
@@ -152,58 +303,66 @@ void IteratorClearWorker::DoExecute() {
 }
 
 IteratorCountWorker::IteratorCountWorker(napi_env env, Database* database,
+                                         ColumnFamily* columnFamily,
                                          napi_value callback, const int limit,
                                          std::string* lt, std::string* lte,
                                          std::string* gt, std::string* gte,
+                                         const bool estimate,
                                          const Snapshot* snapshot)
-    : PriorityWorker(env, database, callback, "rocksdb.iterator.count") {
-  iterator_ = new BaseIterator(database, false, lt, lte, gt, gte, limit, false,
-                               snapshot);
+    : PriorityWorker(env, database, callback, "rocksdb.iterator.count"),
+      limit_(limit),
+      estimate_(estimate) {
+  iterator_ = new BaseIterator(database, columnFamily, false, lt, lte, gt, gte,
+                               limit, false, snapshot);
 }
 
 IteratorCountWorker::IteratorCountWorker(napi_env env, Transaction* transaction,
+                                         ColumnFamily* columnFamily,
                                          napi_value callback, const int limit,
                                          std::string* lt, std::string* lte,
                                          std::string* gt, std::string* gte,
                                          const TransactionSnapshot* snapshot)
-    : PriorityWorker(env, transaction, callback, "rocksdb.iterator.close") {
-  iterator_ = new BaseIterator(transaction, false, lt, lte, gt, gte, limit,
-                               false, snapshot);
+    : PriorityWorker(env, transaction, callback, "rocksdb.iterator.count"),
+      limit_(limit),
+      estimate_(false) {
+  iterator_ = new BaseIterator(transaction, columnFamily, false, lt, lte, gt,
+                               gte, limit, false, snapshot);
 }
 
 IteratorCountWorker::~IteratorCountWorker() { delete iterator_; }
 
+bool IteratorCountWorker::IsLongRunning() const { return !estimate_; }
+
 void IteratorCountWorker::DoExecute() {
   assert(database_ != nullptr || transaction_ != nullptr);
-  iterator_->SeekToRange();
-  uint32_t hwm = 16 * 1024;
-  if (database_ != nullptr) {
-    while (true) {
-      size_t bytesRead = 0;
-      while (bytesRead <= hwm && iterator_->Valid() && iterator_->Increment()) {
-        rocksdb::Slice key = iterator_->CurrentKey();
-        count_++;
-        bytesRead += key.size();
-        iterator_->Next();
-      }
-      if (!SetStatus(iterator_->Status()) || bytesRead == 0) {
-        break;
-      }
+  if (estimate_) {
+    std::string start;
+    std::string end;
+    uint64_t count = 0;
+    if (!iterator_->Bounds(&start, &end)) {
+      SetStatus(iterator_->Status());
+      iterator_->Close();
+      return;
     }
-  } else if (transaction_ != nullptr) {
-    while (true) {
-      size_t bytesRead = 0;
-      while (bytesRead <= hwm && iterator_->Valid() && iterator_->Increment()) {
-        rocksdb::Slice key = iterator_->CurrentKey();
-        count_++;
-        bytesRead += key.size();
-        iterator_->Next();
-      }
-      if (!SetStatus(iterator_->Status()) || bytesRead == 0) {
-        break;
+    // Ranges with range deletions fall through to the exact count
+    if (database_->EstimateCount(iterator_->columnFamily_,
+                                 rocksdb::Range(start, end), &count)) {
+      if (limit_ >= 0 && count > static_cast<uint64_t>(limit_)) {
+        count = limit_;
       }
+      count_ = static_cast<uint32_t>(std::min<uint64_t>(count, UINT32_MAX));
+      iterator_->Close();
+      return;
     }
   }
+  // Only keys are compared, values are never read and the iterator does
+  // not fill the block cache
+  iterator_->SeekToRange();
+  while (iterator_->Valid() && iterator_->Increment()) {
+    count_++;
+    iterator_->Next();
+  }
+  SetStatus(iterator_->Status());
   iterator_->Close();
 }
 
@@ -34,10 +34,12 @@ struct IteratorCloseWorker final : public BaseWorker {
 
 /**
  * Worker class for nexting an iterator.
+ * When `packed` is set, the batch is returned as a single buffer
+ * and a `Uint32Array` of offsets
  */
 struct IteratorNextWorker final : public BaseWorker {
   IteratorNextWorker(napi_env env, Iterator* iterator, uint32_t size,
-                     napi_value callback);
+                     napi_value callback, const bool packed = false);
 
   ~IteratorNextWorker();
 
@@ -50,50 +52,103 @@ struct IteratorNextWorker final : public BaseWorker {
  private:
   Iterator* iterator_;
   uint32_t size_;
+  const bool packed_;
   bool ok_;
 };
 
+/**
+ * Worker class for prefetching the next packed batch of an iterator.
+ * The batch is kept on the iterator until it is asked for
+ */
+struct IteratorPrefetchWorker final : public BaseWorker {
+  IteratorPrefetchWorker(napi_env env, Iterator* iterator,
+                         napi_value callback);
+
+  ~IteratorPrefetchWorker();
+
+  void DoExecute() override;
+
+  void HandleOKCallback(napi_env env, napi_value callback) override;
+
+  void DoFinally(napi_env env) override;
+
+  /**
+   * Queues a prefetch unless the iterator is closing
+   */
+  static void Start(napi_env env, Iterator* iterator);
+
+  /**
+   * Calls `callback` with the prefetched batch
+   * The next prefetch is started before calling back, so reading it
+   * overlaps with the consumer processing this one
+   */
+  static void Deliver(napi_env env, Iterator* iterator, napi_value callback);
+
+ private:
+  Iterator* iterator_;
+};
+
 /**
  * Worker class for deleting a range from a database.
  */
 struct IteratorClearWorker final : public PriorityWorker {
-  IteratorClearWorker(napi_env env, Database* database, napi_value callback,
+  IteratorClearWorker(napi_env env, Database* database,
+                      ColumnFamily* columnFamily, napi_value callback,
                       const int limit, std::string* lt, std::string* lte,
                       std::string* gt, std::string* gte, const bool sync,
                       const Snapshot* snapshot = nullptr);
 
   IteratorClearWorker(napi_env env, Transaction* transaction,
-                      napi_value callback, const int limit, std::string* lt,
-                      std::string* lte, std::string* gt, std::string* gte,
+                      ColumnFamily* columnFamily, napi_value callback,
+                      const int limit, std::string* lt, std::string* lte,
+                      std::string* gt, std::string* gte,
                       const TransactionSnapshot* snapshot = nullptr);
 
   ~IteratorClearWorker();
 
   void DoExecute() override;
 
+  bool IsLongRunning() const override;
+
  private:
   BaseIterator* iterator_;
   rocksdb::WriteOptions* writeOptions_;
+  /**
+   * Without a limit or a snapshot every key in the range is deleted, so a
+   * single range tombstone can replace the per key tombstones
+   */
+  const bool deleteRange_;
 };
 
 struct IteratorCountWorker final : public PriorityWorker {
-  IteratorCountWorker(napi_env env, Database* database, napi_value callback,
+  IteratorCountWorker(napi_env env, Database* database,
+                      ColumnFamily* columnFamily, napi_value callback,
                       const int limit, std::string* lt, std::string* lte,
                       std::string* gt, std::string* gte,
+                      const bool estimate = false,
                       const Snapshot* snapshot = nullptr);
 
   IteratorCountWorker(napi_env env, Transaction* transaction,
-                      napi_value callback, const int limit, std::string* lt,
-                      std::string* lte, std::string* gt, std::string* gte,
+                      ColumnFamily* columnFamily, napi_value callback,
+                      const int limit, std::string* lt, std::string* lte,
+                      std::string* gt, std::string* gte,
                       const TransactionSnapshot* snapshot = nullptr);
 
   ~IteratorCountWorker();
 
   void DoExecute() override;
 
+  bool IsLongRunning() const override;
+
   void HandleOKCallback(napi_env env, napi_value callback) override;
 
  private:
   BaseIterator* iterator_;
+  const int limit_;
+  /**
+   * Estimates from table properties instead of iterating, see
+   * `Database::EstimateCount`
+   */
+  const bool estimate_;
   uint32_t count_ = 0;
 };
@@ -58,28 +58,50 @@ void TransactionRollbackWorker::DoFinally(napi_env env) {
  */
 
 TransactionGetWorker::TransactionGetWorker(napi_env env, Transaction* tran,
+                                           ColumnFamily* columnFamily,
                                            napi_value callback,
                                            rocksdb::Slice key,
                                            const bool asBuffer,
                                            const bool fillCache,
                                            const TransactionSnapshot* snapshot)
     : PriorityWorker(env, tran, callback, "rocksdb.transaction.get"),
+      columnFamily_(columnFamily),
       key_(key),
+      value_(new PinnedValue(tran->database_->blockCache_)),
       asBuffer_(asBuffer) {
   options_.fill_cache = fillCache;
   if (snapshot != nullptr) options_.snapshot = snapshot->snapshot();
 }
 
-TransactionGetWorker::~TransactionGetWorker() { DisposeSliceBuffer(key_); }
+TransactionGetWorker::~TransactionGetWorker() {
+  DisposeSliceBuffer(key_);
+  delete value_;
+}
 
 void TransactionGetWorker::DoExecute() {
-  SetStatus(transaction_->Get(options_, key_, value_));
+  SetStatus(transaction_->Get(options_, columnFamily_->handle_, key_,
+                              &value_->slice_));
+}
+
+bool TransactionGetWorker::DoExecuteFast() {
+  options_.read_tier = rocksdb::kBlockCacheTier;
+  rocksdb::Status status = transaction_->Get(options_, columnFamily_->handle_,
+                                             key_, &value_->slice_);
+  options_.read_tier = rocksdb::kReadAllTier;
+  // Incomplete means the value may be in a block that is not cached
+  if (status.IsIncomplete()) {
+    value_->slice_.Reset();
+    return false;
+  }
+  SetStatus(status);
+  return true;
 }
 
 void TransactionGetWorker::HandleOKCallback(napi_env env, napi_value callback) {
   napi_value argv[2];
   napi_get_null(env, &argv[0]);
-  Entry::Convert(env, &value_, asBuffer_, &argv[1]);
+  Entry::ConvertPinned(env, value_, asBuffer_, &argv[1]);
+  value_ = nullptr;
   CallFunction(env, callback, 2, argv);
 }
 
@@ -88,11 +110,13 @@ void TransactionGetWorker::HandleOKCallback(napi_env env, napi_value callback) {
  */
 
 TransactionGetForUpdateWorker::TransactionGetForUpdateWorker(
-    napi_env env, Transaction* tran, napi_value callback, rocksdb::Slice key,
-    const bool asBuffer, const bool fillCache,
-    const TransactionSnapshot* snapshot)
+    napi_env env, Transaction* tran, ColumnFamily* columnFamily,
+    napi_value callback, rocksdb::Slice key, const bool asBuffer,
+    const bool fillCache, const TransactionSnapshot* snapshot)
     : PriorityWorker(env, tran, callback, "rocksdb.transaction.get_for_update"),
+      columnFamily_(columnFamily),
       key_(key),
+      value_(new PinnedValue(tran->database_->blockCache_)),
       asBuffer_(asBuffer) {
   options_.fill_cache = fillCache;
   if (snapshot != nullptr) options_.snapshot = snapshot->snapshot();
@@ -100,17 +124,20 @@ TransactionGetForUpdateWorker::TransactionGetForUpdateWorker(
 
 TransactionGetForUpdateWorker::~TransactionGetForUpdateWorker() {
   DisposeSliceBuffer(key_);
+  delete value_;
 }
 
 void TransactionGetForUpdateWorker::DoExecute() {
-  SetStatus(transaction_->GetForUpdate(options_, key_, value_));
+  SetStatus(transaction_->GetForUpdate(options_, columnFamily_->handle_, key_,
+                                       &value_->slice_));
 }
 
 void TransactionGetForUpdateWorker::HandleOKCallback(napi_env env,
                                                      napi_value callback) {
   napi_value argv[2];
   napi_get_null(env, &argv[0]);
-  Entry::Convert(env, &value_, asBuffer_, &argv[1]);
+  Entry::ConvertPinned(env, value_, asBuffer_, &argv[1]);
+  value_ = nullptr;
   CallFunction(env, callback, 2, argv);
 }
 
@@ -119,39 +146,47 @@ void TransactionGetForUpdateWorker::HandleOKCallback(napi_env env,
  */
 
 TransactionMultiGetWorker::TransactionMultiGetWorker(
-    napi_env env, Transaction* transaction,
+    napi_env env, Transaction* transaction, ColumnFamily* columnFamily,
     const std::vector<rocksdb::Slice>* keys, napi_value callback,
     const bool valueAsBuffer, const bool fillCache,
     const TransactionSnapshot* snapshot)
     : PriorityWorker(env, transaction, callback,
                      "rocksdb.transaction.multiget"),
+      columnFamily_(columnFamily),
       keys_(keys),
       valueAsBuffer_(valueAsBuffer) {
   options_.fill_cache = fillCache;
   if (snapshot) options_.snapshot = snapshot->snapshot();
 }
 
-TransactionMultiGetWorker::~TransactionMultiGetWorker() { delete keys_; }
+TransactionMultiGetWorker::~TransactionMultiGetWorker() {
+  for (const rocksdb::Slice& key : *keys_) DisposeSliceBuffer(key);
+  delete keys_;
+  for (PinnedValue* value : values_) delete value;
+}
 
 void TransactionMultiGetWorker::DoExecute() {
-  // NAPI requires a vector of string pointers
-  // the nullptr can be used to represent `undefined`
-  values_.reserve(keys_->size());
-  // RocksDB requires just a vector of strings
-  // these will be automatically deallocated
-  std::vector<std::string> values(keys_->size());
-  std::vector<rocksdb::Status> statuses =
-      transaction_->MultiGet(options_, *keys_, values);
-  for (size_t i = 0; i != statuses.size(); i++) {
+  // Batched lookups require the keys in ascending order
+  const std::vector<size_t> order = SortedKeyOrder(*keys_);
+  const size_t size = order.size();
+  std::vector<rocksdb::Slice> keys;
+  keys.reserve(size);
+  for (size_t i = 0; i < size; i++) {
+    keys.push_back((*keys_)[order[i]]);
+  }
+  std::vector<rocksdb::PinnableSlice> values(size);
+  std::vector<rocksdb::Status> statuses(size);
+  transaction_->MultiGet(options_, columnFamily_->handle_, size, keys.data(),
+                         values.data(), statuses.data(), true);
+  // The nullptr is used to represent `undefined`
+  values_.assign(size, nullptr);
+  for (size_t i = 0; i < size; i++) {
     if (statuses[i].ok()) {
-      std::string* value = new std::string(values[i]);
-      values_.push_back(value);
-    } else if (statuses[i].IsNotFound()) {
-      values_.push_back(nullptr);
-    } else {
-      for (const std::string* value : values_) {
-        if (value != NULL) delete value;
-      }
+      PinnedValue* value =
+          new PinnedValue(transaction_->database_->blockCache_);
+      value->slice_ = std::move(values[i]);
+      values_[order[i]] = value;
+    } else if (!statuses[i].IsNotFound()) {
       SetStatus(statuses[i]);
       break;
     }
@@ -165,11 +200,14 @@ void TransactionMultiGetWorker::HandleOKCallback(napi_env env,
   napi_create_array_with_length(env, size, &array);
 
   for (size_t idx = 0; idx < size; idx++) {
-    std::string* value = values_[idx];
     napi_value element;
-    Entry::Convert(env, value, valueAsBuffer_, &element);
+    if (values_[idx] == nullptr) {
+      napi_get_undefined(env, &element);
+    } else {
+      Entry::ConvertPinned(env, values_[idx], valueAsBuffer_, &element);
+      values_[idx] = nullptr;
+    }
     napi_set_element(env, array, static_cast<uint32_t>(idx), element);
-    if (value != nullptr) delete value;
   }
 
   napi_value argv[2];
@@ -183,12 +221,13 @@ void TransactionMultiGetWorker::HandleOKCallback(napi_env env,
  */
 
 TransactionMultiGetForUpdateWorker::TransactionMultiGetForUpdateWorker(
-    napi_env env, Transaction* transaction,
+    napi_env env, Transaction* transaction, ColumnFamily* columnFamily,
     const std::vector<rocksdb::Slice>* keys, napi_value callback,
     const bool valueAsBuffer, const bool fillCache,
     const TransactionSnapshot* snapshot)
     : PriorityWorker(env, transaction, callback,
                      "rocksdb.transaction.multiget_for_update"),
+      columnFamily_(columnFamily),
       keys_(keys),
       valueAsBuffer_(valueAsBuffer) {
   options_.fill_cache = fillCache;
@@ -196,6 +235,7 @@ TransactionMultiGetForUpdateWorker::TransactionMultiGetForUpdateWorker(
 }
 
 TransactionMultiGetForUpdateWorker::~TransactionMultiGetForUpdateWorker() {
+  for (const rocksdb::Slice& key : *keys_) DisposeSliceBuffer(key);
   delete keys_;
 }
 
@@ -206,11 +246,11 @@ void TransactionMultiGetForUpdateWorker::DoExecute() {
   // RocksDB requires just a vector of strings
   // these will be automatically deallocated
   std::vector<std::string> values(keys_->size());
-  std::vector<rocksdb::Status> statuses =
-      transaction_->MultiGetForUpdate(options_, *keys_, values);
+  std::vector<rocksdb::Status> statuses = transaction_->MultiGetForUpdate(
+      options_, columnFamily_->handle_, *keys_, values);
   for (size_t i = 0; i != statuses.size(); i++) {
     if (statuses[i].ok()) {
-      std::string* value = new std::string(values[i]);
+      std::string* value = new std::string(std::move(values[i]));
       values_.push_back(value);
     } else if (statuses[i].IsNotFound()) {
       values_.push_back(nullptr);
@@ -233,7 +273,7 @@ void TransactionMultiGetForUpdateWorker::HandleOKCallback(napi_env env,
   for (size_t idx = 0; idx < size; idx++) {
     std::string* value = values_[idx];
     napi_value element;
-    Entry::Convert(env, value, valueAsBuffer_, &element);
+    Entry::ConvertMove(env, value, valueAsBuffer_, &element);
     napi_set_element(env, array, static_cast<uint32_t>(idx), element);
     if (value != nullptr) delete value;
   }
@@ -249,10 +289,12 @@ void TransactionMultiGetForUpdateWorker::HandleOKCallback(napi_env env,
  */
 
 TransactionPutWorker::TransactionPutWorker(napi_env env, Transaction* tran,
+                                           ColumnFamily* columnFamily,
                                            napi_value callback,
                                            rocksdb::Slice key,
                                            rocksdb::Slice value)
     : PriorityWorker(env, tran, callback, "rocksdb.transaction.put"),
+      columnFamily_(columnFamily),
       key_(key),
       value_(value) {}
 
@@ -262,7 +304,7 @@ TransactionPutWorker::~TransactionPutWorker() {
 }
 
 void TransactionPutWorker::DoExecute() {
-  SetStatus(transaction_->Put(key_, value_));
+  SetStatus(transaction_->Put(columnFamily_->handle_, key_, value_));
 }
 
 /**
@@ -270,11 +312,15 @@ void TransactionPutWorker::DoExecute() {
  */
 
 TransactionDelWorker::TransactionDelWorker(napi_env env, Transaction* tran,
+                                           ColumnFamily* columnFamily,
                                            napi_value callback,
                                            rocksdb::Slice key)
     : PriorityWorker(env, tran, callback, "rocksdb.transaction.del"),
+      columnFamily_(columnFamily),
       key_(key) {}
 
 TransactionDelWorker::~TransactionDelWorker() { DisposeSliceBuffer(key_); }
 
-void TransactionDelWorker::DoExecute() { SetStatus(transaction_->Del(key_)); }
+void TransactionDelWorker::DoExecute() {
+  SetStatus(transaction_->Del(columnFamily_->handle_, key_));
+}
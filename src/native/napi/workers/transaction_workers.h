@@ -14,6 +14,7 @@
 
 #include "../worker.h"
 #include "../transaction.h"
+#include "../iterator.h"
 #include "../snapshot.h"
 
 /**
@@ -47,7 +48,8 @@ struct TransactionRollbackWorker final : public BaseWorker {
  * Worker for transaction get
  */
 struct TransactionGetWorker final : public PriorityWorker {
-  TransactionGetWorker(napi_env env, Transaction* tran, napi_value callback,
+  TransactionGetWorker(napi_env env, Transaction* tran,
+                       ColumnFamily* columnFamily, napi_value callback,
                        rocksdb::Slice key, const bool asBuffer,
                        const bool fillCache,
                        const TransactionSnapshot* snapshot = nullptr);
@@ -56,12 +58,18 @@ struct TransactionGetWorker final : public PriorityWorker {
 
   void DoExecute() override;
 
+  /**
+   * Reads from the memtables and the block cache only
+   */
+  bool DoExecuteFast() override;
+
   void HandleOKCallback(napi_env env, napi_value callback) override;
 
  private:
   rocksdb::ReadOptions options_;
+  ColumnFamily* columnFamily_;
   rocksdb::Slice key_;
-  std::string value_;
+  PinnedValue* value_;
   const bool asBuffer_;
 };
 
@@ -70,6 +78,7 @@ struct TransactionGetWorker final : public PriorityWorker {
  */
 struct TransactionGetForUpdateWorker final : public PriorityWorker {
   TransactionGetForUpdateWorker(napi_env env, Transaction* tran,
+                                ColumnFamily* columnFamily,
                                 napi_value callback, rocksdb::Slice key,
                                 const bool asBuffer, const bool fillCache,
                                 const TransactionSnapshot* snapshot = nullptr);
@@ -82,13 +91,15 @@ struct TransactionGetForUpdateWorker final : public PriorityWorker {
 
  private:
   rocksdb::ReadOptions options_;
+  ColumnFamily* columnFamily_;
   rocksdb::Slice key_;
-  std::string value_;
+  PinnedValue* value_;
   const bool asBuffer_;
 };
 
 struct TransactionMultiGetWorker final : public PriorityWorker {
   TransactionMultiGetWorker(napi_env env, Transaction* transaction,
+                            ColumnFamily* columnFamily,
                             const std::vector<rocksdb::Slice>* keys,
                             napi_value callback, const bool valueAsBuffer,
                             const bool fillCache,
@@ -102,14 +113,15 @@ struct TransactionMultiGetWorker final : public PriorityWorker {
 
  private:
   rocksdb::ReadOptions options_;
+  ColumnFamily* columnFamily_;
   const std::vector<rocksdb::Slice>* keys_;
-  std::vector<std::string*> values_;
+  std::vector<PinnedValue*> values_;
   const bool valueAsBuffer_;
 };
 
 struct TransactionMultiGetForUpdateWorker final : public PriorityWorker {
   TransactionMultiGetForUpdateWorker(
-      napi_env env, Transaction* transaction,
+      napi_env env, Transaction* transaction, ColumnFamily* columnFamily,
       const std::vector<rocksdb::Slice>* keys, napi_value callback,
       const bool valueAsBuffer, const bool fillCache,
       const TransactionSnapshot* snapshot = nullptr);
@@ -122,6 +134,7 @@ struct TransactionMultiGetForUpdateWorker final : public PriorityWorker {
 
  private:
   rocksdb::ReadOptions options_;
+  ColumnFamily* columnFamily_;
   const std::vector<rocksdb::Slice>* keys_;
   std::vector<std::string*> values_;
   const bool valueAsBuffer_;
@@ -131,7 +144,8 @@ struct TransactionMultiGetForUpdateWorker final : public PriorityWorker {
  * Worker for transaction put
  */
 struct TransactionPutWorker final : public PriorityWorker {
-  TransactionPutWorker(napi_env env, Transaction* tran, napi_value callback,
+  TransactionPutWorker(napi_env env, Transaction* tran,
+                       ColumnFamily* columnFamily, napi_value callback,
                        rocksdb::Slice key, rocksdb::Slice value);
 
   ~TransactionPutWorker();
@@ -139,6 +153,7 @@ struct TransactionPutWorker final : public PriorityWorker {
   void DoExecute() override;
 
  private:
+  ColumnFamily* columnFamily_;
   rocksdb::Slice key_;
   rocksdb::Slice value_;
 };
@@ -147,7 +162,8 @@ struct TransactionPutWorker final : public PriorityWorker {
  * Worker for transaction del
  */
 struct TransactionDelWorker final : public PriorityWorker {
-  TransactionDelWorker(napi_env env, Transaction* tran, napi_value callback,
+  TransactionDelWorker(napi_env env, Transaction* tran,
+                       ColumnFamily* columnFamily, napi_value callback,
                        rocksdb::Slice key);
 
   ~TransactionDelWorker();
@@ -155,5 +171,6 @@ struct TransactionDelWorker final : public PriorityWorker {
   void DoExecute() override;
 
  private:
+  ColumnFamily* columnFamily_;
   rocksdb::Slice key_;
 };
@@ -1,11 +1,18 @@
 import type { Callback } from '../types';
 import type {
+  RocksDBCache,
+  RocksDBCacheOptions,
+  RocksDBWriteBufferManager,
+  RocksDBWriteBufferManagerOptions,
+  RocksDBWriteBufferManagerUsage,
   RocksDBDatabase,
   RocksDBIterator,
   RocksDBTransaction,
   RocksDBSnapshot,
   RocksDBTransactionSnapshot,
   RocksDBBatch,
+  RocksDBColumnFamily,
+  RocksDBColumnFamilyOption,
   RocksDBDatabaseOptions,
   RocksDBGetOptions,
   RocksDBPutOptions,
@@ -17,11 +24,21 @@ import type {
   RocksDBBatchDelOperation,
   RocksDBBatchPutOperation,
   RocksDBCountOptions,
+  RocksDBStatistics,
+  RocksDBPerfOption,
+  RocksDBWorkerLatency,
 } from './types';
 import path from 'path';
 import nodeGypBuild from 'node-gyp-build';
 
 interface RocksDB {
+  cacheInit(options: RocksDBCacheOptions): RocksDBCache;
+  writeBufferManagerInit(
+    options: RocksDBWriteBufferManagerOptions,
+  ): RocksDBWriteBufferManager;
+  writeBufferManagerUsage(
+    writeBufferManager: RocksDBWriteBufferManager,
+  ): RocksDBWriteBufferManagerUsage;
   dbInit(): RocksDBDatabase;
   dbOpen(
     database: RocksDBDatabase,
@@ -30,6 +47,10 @@ interface RocksDB {
     callback: Callback<[], void>,
   ): void;
   dbClose(database: RocksDBDatabase, callback: Callback<[], void>): void;
+  /**
+   * Calls back before returning when the value is found in the memtables or
+   * the block cache
+   */
   dbGet(
     database: RocksDBDatabase,
     key: string | Buffer,
@@ -90,6 +111,17 @@ interface RocksDB {
     callback: Callback<[], void>,
   ): void;
   dbGetProperty(database: RocksDBDatabase, property: string): string;
+  dbGetStatistics(database: RocksDBDatabase): RocksDBStatistics | undefined;
+  dbResetStatistics(database: RocksDBDatabase): void;
+  dbColumnFamily(
+    database: RocksDBDatabase,
+    name: string,
+  ): RocksDBColumnFamily | undefined;
+  dbDropColumnFamily(
+    database: RocksDBDatabase,
+    columnFamily: RocksDBColumnFamily,
+    callback: Callback<[], void>,
+  ): void;
   snapshotInit(database: RocksDBDatabase): RocksDBSnapshot;
   snapshotRelease(
     snapshot: RocksDBSnapshot,
@@ -97,6 +129,7 @@ interface RocksDB {
   ): void;
   destroyDb(location: string, callback: Callback<[], void>): void;
   repairDb(location: string, callback: Callback<[], void>): void;
+  workerLatencies(): Record<string, RocksDBWorkerLatency>;
   iteratorInit(
     database: RocksDBDatabase,
     options: RocksDBIteratorOptions & {
@@ -126,6 +159,25 @@ interface RocksDB {
     size: number,
     callback: Callback<[Array<[K, V]>, boolean], void>,
   ): void;
+  iteratorNextv<K extends string | Buffer, V extends string | Buffer>(
+    iterator: RocksDBIterator<K, V>,
+    size: number,
+    options: RocksDBPerfOption,
+    callback: Callback<[Array<[K, V]>, boolean], void>,
+  ): void;
+  /**
+   * Packed variant of `iteratorNextv`
+   * Keys and values are concatenated into a single buffer regardless of
+   * the iterator's encodings, `offsets` has the end offset of each key
+   * followed by the end offset of its value
+   * Prefetching iterators reject a request made while another is still
+   * waiting for the prefetch with `ITERATOR_BUSY`
+   */
+  iteratorNextvPacked(
+    iterator: RocksDBIterator,
+    size: number,
+    callback: Callback<[Buffer, Uint32Array, boolean], void>,
+  ): void;
   batchDo(
     database: RocksDBDatabase,
     operations: Array<RocksDBBatchPutOperation | RocksDBBatchDelOperation>,
@@ -137,8 +189,13 @@ interface RocksDB {
     batch: RocksDBBatch,
     key: string | Buffer,
     value: string | Buffer,
+    options?: RocksDBColumnFamilyOption,
+  ): void;
+  batchDel(
+    batch: RocksDBBatch,
+    key: string | Buffer,
+    options?: RocksDBColumnFamilyOption,
   ): void;
-  batchDel(batch: RocksDBBatch, key: string | Buffer): void;
   batchClear(batch: RocksDBBatch): void;
   batchWrite(
     batch: RocksDBBatch,
@@ -158,6 +215,10 @@ interface RocksDB {
     transaction: RocksDBTransaction,
     callback: Callback<[], void>,
   ): void;
+  /**
+   * Calls back before returning when the value is found in the transaction,
+   * the memtables or the block cache
+   */
   transactionGet(
     transaction: RocksDBTransaction,
     key: string | Buffer,
@@ -228,9 +289,22 @@ interface RocksDB {
     value: string | Buffer,
     callback: Callback<[], void>,
   ): void;
+  transactionPut(
+    transaction: RocksDBTransaction,
+    key: string | Buffer,
+    value: string | Buffer,
+    options: RocksDBColumnFamilyOption,
+    callback: Callback<[], void>,
+  ): void;
+  transactionDel(
+    transaction: RocksDBTransaction,
+    key: string | Buffer,
+    callback: Callback<[], void>,
+  ): void;
   transactionDel(
     transaction: RocksDBTransaction,
     key: string | Buffer,
+    options: RocksDBColumnFamilyOption,
     callback: Callback<[], void>,
   ): void;
   transactionSnapshot(
@@ -269,6 +343,9 @@ interface RocksDB {
     options: RocksDBCountOptions<RocksDBTransactionSnapshot>,
     callback: Callback<[number], void>,
   ): void;
+  keyPathToKey(keyPath: Readonly<Array<string | Buffer>>): Buffer;
+  levelPathToKey(levelPath: Readonly<Array<string | Buffer>>): Buffer;
+  parseKey(key: Buffer): Array<Buffer>;
 }
 
 const rocksdb: RocksDB = nodeGypBuild(path.join(__dirname, '../../'));
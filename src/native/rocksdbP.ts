@@ -1,10 +1,17 @@
 import type {
+  RocksDBCache,
+  RocksDBCacheOptions,
+  RocksDBWriteBufferManager,
+  RocksDBWriteBufferManagerOptions,
+  RocksDBWriteBufferManagerUsage,
   RocksDBDatabase,
   RocksDBIterator,
   RocksDBTransaction,
   RocksDBSnapshot,
   RocksDBTransactionSnapshot,
   RocksDBBatch,
+  RocksDBColumnFamily,
+  RocksDBColumnFamilyOption,
   RocksDBDatabaseOptions,
   RocksDBGetOptions,
   RocksDBPutOptions,
@@ -16,11 +23,21 @@ import type {
   RocksDBBatchOptions,
   RocksDBBatchDelOperation,
   RocksDBBatchPutOperation,
+  RocksDBStatistics,
+  RocksDBPerfOption,
+  RocksDBWorkerLatency,
 } from './types';
 import rocksdb from './rocksdb';
 import * as utils from '../utils';
 
 interface RocksDBP {
+  cacheInit(options: RocksDBCacheOptions): RocksDBCache;
+  writeBufferManagerInit(
+    options: RocksDBWriteBufferManagerOptions,
+  ): RocksDBWriteBufferManager;
+  writeBufferManagerUsage(
+    writeBufferManager: RocksDBWriteBufferManager,
+  ): RocksDBWriteBufferManagerUsage;
   dbInit(): RocksDBDatabase;
   dbOpen(
     database: RocksDBDatabase,
@@ -78,10 +95,21 @@ interface RocksDBP {
     end: string | Buffer,
   ): Promise<void>;
   dbGetProperty(database: RocksDBDatabase, property: string): string;
+  dbGetStatistics(database: RocksDBDatabase): RocksDBStatistics | undefined;
+  dbResetStatistics(database: RocksDBDatabase): void;
+  dbColumnFamily(
+    database: RocksDBDatabase,
+    name: string,
+  ): RocksDBColumnFamily | undefined;
+  dbDropColumnFamily(
+    database: RocksDBDatabase,
+    columnFamily: RocksDBColumnFamily,
+  ): Promise<void>;
   snapshotInit(database: RocksDBDatabase): RocksDBSnapshot;
   snapshotRelease(snapshot: RocksDBSnapshot): Promise<void>;
   destroyDb(location: string): Promise<void>;
   repairDb(location: string): Promise<void>;
+  workerLatencies(): Record<string, RocksDBWorkerLatency>;
   iteratorInit(
     database: RocksDBDatabase,
     options: RocksDBIteratorOptions & {
@@ -109,7 +137,12 @@ interface RocksDBP {
   iteratorNextv<K extends string | Buffer, V extends string | Buffer>(
     iterator: RocksDBIterator<K, V>,
     size: number,
+    options?: RocksDBPerfOption,
   ): Promise<[Array<[K, V]>, boolean]>;
+  iteratorNextvPacked(
+    iterator: RocksDBIterator,
+    size: number,
+  ): Promise<[Buffer, Uint32Array, boolean]>;
   batchDo(
     database: RocksDBDatabase,
     operations: Array<RocksDBBatchPutOperation | RocksDBBatchDelOperation>,
@@ -120,8 +153,13 @@ interface RocksDBP {
     batch: RocksDBBatch,
     key: string | Buffer,
     value: string | Buffer,
+    options?: RocksDBColumnFamilyOption,
+  ): void;
+  batchDel(
+    batch: RocksDBBatch,
+    key: string | Buffer,
+    options?: RocksDBColumnFamilyOption,
   ): void;
-  batchDel(batch: RocksDBBatch, key: string | Buffer): void;
   batchClear(batch: RocksDBBatch): void;
   batchWrite(batch: RocksDBBatch, options: RocksDBBatchOptions): Promise<void>;
   transactionInit(
@@ -191,10 +229,12 @@ interface RocksDBP {
     transaction: RocksDBTransaction,
     key: string | Buffer,
     value: string | Buffer,
+    options?: RocksDBColumnFamilyOption,
   ): Promise<void>;
   transactionDel(
     transaction: RocksDBTransaction,
     key: string | Buffer,
+    options?: RocksDBColumnFamilyOption,
   ): Promise<void>;
   transactionSnapshot(
     transaction: RocksDBTransaction,
@@ -230,12 +270,18 @@ interface RocksDBP {
     transaction: RocksDBTransaction,
     options: RocksDBCountOptions<RocksDBTransactionSnapshot>,
   ): Promise<number>;
+  keyPathToKey(keyPath: Readonly<Array<string | Buffer>>): Buffer;
+  levelPathToKey(levelPath: Readonly<Array<string | Buffer>>): Buffer;
+  parseKey(key: Buffer): Array<Buffer>;
 }
 
 /**
  * Promisified version of RocksDB
  */
 const rocksdbP: RocksDBP = {
+  cacheInit: rocksdb.cacheInit.bind(rocksdb),
+  writeBufferManagerInit: rocksdb.writeBufferManagerInit.bind(rocksdb),
+  writeBufferManagerUsage: rocksdb.writeBufferManagerUsage.bind(rocksdb),
   dbInit: rocksdb.dbInit.bind(rocksdb),
   dbOpen: utils.promisify(rocksdb.dbOpen).bind(rocksdb),
   dbClose: utils.promisify(rocksdb.dbClose).bind(rocksdb),
@@ -248,14 +294,22 @@ const rocksdbP: RocksDBP = {
   dbApproximateSize: utils.promisify(rocksdb.dbApproximateSize).bind(rocksdb),
   dbCompactRange: utils.promisify(rocksdb.dbCompactRange).bind(rocksdb),
   dbGetProperty: rocksdb.dbGetProperty.bind(rocksdb),
+  dbGetStatistics: rocksdb.dbGetStatistics.bind(rocksdb),
+  dbResetStatistics: rocksdb.dbResetStatistics.bind(rocksdb),
+  dbColumnFamily: rocksdb.dbColumnFamily.bind(rocksdb),
+  dbDropColumnFamily: utils.promisify(rocksdb.dbDropColumnFamily).bind(rocksdb),
   snapshotInit: rocksdb.snapshotInit.bind(rocksdb),
   snapshotRelease: utils.promisify(rocksdb.snapshotRelease).bind(rocksdb),
   destroyDb: utils.promisify(rocksdb.destroyDb).bind(rocksdb),
   repairDb: utils.promisify(rocksdb.repairDb).bind(rocksdb),
+  workerLatencies: rocksdb.workerLatencies.bind(rocksdb),
   iteratorInit: rocksdb.iteratorInit.bind(rocksdb),
   iteratorSeek: rocksdb.iteratorSeek.bind(rocksdb),
   iteratorClose: utils.promisify(rocksdb.iteratorClose).bind(rocksdb),
   iteratorNextv: utils.promisify(rocksdb.iteratorNextv).bind(rocksdb),
+  iteratorNextvPacked: utils
+    .promisify(rocksdb.iteratorNextvPacked)
+    .bind(rocksdb),
   batchDo: utils.promisify(rocksdb.batchDo).bind(rocksdb),
   batchInit: rocksdb.batchInit.bind(rocksdb),
   batchPut: rocksdb.batchPut.bind(rocksdb),
@@ -284,6 +338,9 @@ const rocksdbP: RocksDBP = {
   transactionIteratorInit: rocksdb.transactionIteratorInit.bind(rocksdb),
   transactionClear: utils.promisify(rocksdb.transactionClear).bind(rocksdb),
   transactionCount: utils.promisify(rocksdb.transactionCount).bind(rocksdb),
+  keyPathToKey: rocksdb.keyPathToKey.bind(rocksdb),
+  levelPathToKey: rocksdb.levelPathToKey.bind(rocksdb),
+  parseKey: rocksdb.parseKey.bind(rocksdb),
 };
 
 export default rocksdbP;
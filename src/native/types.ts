@@ -53,20 +53,305 @@ type RocksDBSnapshot = Opaque<'RocksDBSnapshot', object>;
  */
 type RocksDBTransactionSnapshot = Opaque<'RocksDBTransactionSnapshot', object>;
 
+/**
+ * RocksDBCache object
+ * A `napi_external` type
+ * Databases opened with it keep it alive
+ */
+type RocksDBCache = Opaque<'RocksDBCache', object>;
+
+/**
+ * RocksDBWriteBufferManager object
+ * A `napi_external` type
+ * Databases opened with it keep it alive
+ */
+type RocksDBWriteBufferManager = Opaque<'RocksDBWriteBufferManager', object>;
+
+/**
+ * RocksDBColumnFamily object
+ * A `napi_external` type
+ * It is owned by the database and is valid until the database is closed
+ * Using it with any other database throws `COLUMN_FAMILY_INVALID`
+ */
+type RocksDBColumnFamily = Opaque<'RocksDBColumnFamily', object>;
+
+/**
+ * RocksDB compression, `true` is `'snappy'` and `false` is `'none'`
+ * Other values fail `dbOpen` with `DB_OPEN`
+ */
+type RocksDBCompression =
+  | boolean
+  | 'none'
+  | 'snappy'
+  | 'lz4'
+  | 'lz4hc'
+  | 'zstd';
+
+/**
+ * RocksDB column family options
+ * Defaults are taken from the database options
+ */
+type RocksDBColumnFamilyOptions = {
+  compression?: RocksDBCompression;
+  compressionPerLevel?: Array<RocksDBCompression>;
+  bottommostCompression?: RocksDBCompression;
+  compressionLevel?: number;
+  compressionDictBytes?: number;
+  compressionDictTrainBytes?: number;
+  writeBufferSize?: number;
+  maxWriteBufferNumber?: number;
+  minWriteBufferNumberToMerge?: number;
+  blockSize?: number;
+  blockRestartInterval?: number;
+  prefixLevels?: number;
+  partitionedIndexFilters?: boolean;
+  cacheIndexAndFilterBlocks?: boolean;
+  pinL0FilterAndIndexBlocks?: boolean;
+  dataBlockHashIndex?: boolean;
+  filterBitsPerKey?: number;
+  filterPolicy?: 'bloom' | 'ribbon';
+  formatVersion?: number;
+  enableBlobFiles?: boolean;
+  minBlobSize?: number;
+  blobFileSize?: number;
+  blobCompression?: RocksDBCompression;
+  enableBlobGarbageCollection?: boolean;
+  blobGarbageCollectionAgeCutoff?: number;
+};
+
+/**
+ * RocksDB block cache options
+ */
+type RocksDBCacheOptions = {
+  size?: number; // Default 8 * 1024 * 1024
+  /**
+   * The clock cache avoids the LRU's lock on lookups, it is only available
+   * when RocksDB is built with TBB
+   */
+  type?: 'lru' | 'clock'; // Default 'lru'
+  /**
+   * The cache is split into `2 ** shardBits` shards with their own locks
+   */
+  shardBits?: number; // Default -1, picked from the size
+  /**
+   * Inserts fail instead of going over the size
+   */
+  strictCapacityLimit?: boolean; // Default false
+};
+
+/**
+ * RocksDB write buffer manager options
+ */
+type RocksDBWriteBufferManagerOptions = {
+  /**
+   * Memtable memory of all databases using the write buffer manager
+   */
+  size?: number; // Default 64 * 1024 * 1024
+  /**
+   * Charges memtable memory to this cache, so both share its size
+   */
+  cache?: RocksDBCache; // Default undefined
+};
+
+/**
+ * Memtable memory of a write buffer manager in bytes
+ */
+type RocksDBWriteBufferManagerUsage = {
+  size: number;
+  usage: number;
+  mutableUsage: number;
+};
+
 /**
  * RocksDB database options
+ * These apply to the default column family
  */
 type RocksDBDatabaseOptions = {
   createIfMissing?: boolean; // Default true
   errorIfExists?: boolean; // Default false
-  compression?: boolean; // Default true
+  compression?: RocksDBCompression; // Default true
+  /**
+   * Compression of each level from level 0, this overrides `compression`
+   * Levels past the end use the last compression
+   */
+  compressionPerLevel?: Array<RocksDBCompression>; // Default []
+  /**
+   * Compression of the bottommost level, which holds most of the data
+   */
+  bottommostCompression?: RocksDBCompression; // Default is `compression`
+  compressionLevel?: number; // Default is the library's default level
+  /**
+   * Size of the dictionary shared by the blocks of each table, dictionaries
+   * help with many small similar values
+   */
+  compressionDictBytes?: number; // Default 0, dictionaries are disabled
+  /**
+   * Samples ZSTD trains the dictionary on, 0 uses the samples as the
+   * dictionary
+   */
+  compressionDictTrainBytes?: number; // Default 0
   infoLogLevel?: 'debug' | 'info' | 'warn' | 'error' | 'fatal' | 'header'; // Default undefined
+  /**
+   * Size of an LRU cache of the database's own, 0 disables the block cache
+   */
   cacheSize?: number; // Default 8 * 1024 * 1024
+  /**
+   * Cache shared with other databases, see `cacheInit`
+   * This takes precedence over `cacheSize`
+   */
+  cache?: RocksDBCache; // Default undefined
   writeBufferSize?: number; // Default 4 * 1024 * 1024
+  /**
+   * Write buffer manager shared with other databases, see
+   * `writeBufferManagerInit`
+   * Memtables are flushed early once all of them go over its size
+   */
+  writeBufferManager?: RocksDBWriteBufferManager; // Default undefined
+  /**
+   * Memtables kept in memory, writes stall when all of them are full
+   */
+  maxWriteBufferNumber?: number; // Default 2
+  /**
+   * Immutable memtables merged together when flushed
+   */
+  minWriteBufferNumberToMerge?: number; // Default 1
   blockSize?: number; // Default 4096
   maxOpenFiles?: number; // Default 1000
   blockRestartInterval?: number; // Default 16
   maxFileSize?: number; // Default 2 * 1024 * 1024
+  /**
+   * Writes the WAL and the memtable in separate stages, so concurrent
+   * writers overlap
+   */
+  pipelinedWrite?: boolean; // Default false
+  /**
+   * Writers of a write group insert into the memtable in parallel
+   */
+  concurrentMemtableWrite?: boolean; // Default true
+  /**
+   * Collects tickers and histograms, see `dbGetStatistics`
+   * This costs a few percent of throughput
+   */
+  statistics?: boolean; // Default false
+  prefixLevels?: number; // Default 0, LevelPath prefix extractor is disabled
+  /**
+   * Partitions the index and the filters of each table, so only their top
+   * level has to stay in memory
+   */
+  partitionedIndexFilters?: boolean; // Default false
+  /**
+   * Keeps index and filter blocks in the block cache at high priority
+   * instead of in table readers, so they count against the cache size
+   * This requires a block cache
+   */
+  cacheIndexAndFilterBlocks?: boolean; // Default false
+  /**
+   * Pins the index and filter blocks of level 0 tables in the block cache,
+   * this requires `cacheIndexAndFilterBlocks`
+   */
+  pinL0FilterAndIndexBlocks?: boolean; // Default false
+  /**
+   * Adds a hash index to data blocks, point lookups skip the binary search
+   */
+  dataBlockHashIndex?: boolean; // Default false
+  filterBitsPerKey?: number; // Default 10, 0 disables filters
+  /**
+   * Ribbon filters use about 30% less memory than bloom filters for the
+   * same false positive rate but are slower to build, they need a
+   * `formatVersion` of at least 5 and tables get bloom filters otherwise
+   */
+  filterPolicy?: 'bloom' | 'ribbon'; // Default 'bloom'
+  formatVersion?: number; // Default is RocksDB's default
+  /**
+   * Writes large values to blob files and only keeps references to them in
+   * tables, so compactions do not rewrite the values
+   */
+  enableBlobFiles?: boolean; // Default false
+  minBlobSize?: number; // Default 0, all values go to blob files
+  blobFileSize?: number; // Default 256 * 1024 * 1024
+  blobCompression?: RocksDBCompression; // Default 'none'
+  /**
+   * Compactions move the live values out of the oldest blob files, so
+   * overwritten and deleted values are reclaimed
+   */
+  enableBlobGarbageCollection?: boolean; // Default false
+  /**
+   * Fraction of the oldest blob files that are garbage collected
+   */
+  blobGarbageCollectionAgeCutoff?: number; // Default 0.25
+  /**
+   * Threads of the database's own executor, 0 runs the workers on the
+   * libuv thread pool instead
+   */
+  workerThreads?: number; // Default 4
+  /**
+   * Threads for long running workers such as compactions, clears and
+   * exact counts, 0 runs them with the other workers
+   */
+  longWorkerThreads?: number; // Default 1
+  /**
+   * Column families by name, missing ones are created
+   * Existing column families that are not listed are opened with the
+   * database options
+   */
+  columnFamilies?: Record<string, RocksDBColumnFamilyOptions>; // Default {}
+};
+
+/**
+ * Column family option shared by operations
+ */
+type RocksDBColumnFamilyOption = {
+  columnFamily?: RocksDBColumnFamily; // Default is the default column family
+};
+
+/**
+ * Breakdown of the execution of an operation from RocksDB's perf context
+ * and IO stats context
+ * Times are in nanoseconds
+ */
+type RocksDBPerfContext = {
+  userKeyComparisonCount: number;
+  blockCacheHitCount: number;
+  blockReadCount: number;
+  blockReadBytes: number;
+  blockReadNanos: number;
+  blockChecksumNanos: number;
+  blockDecompressNanos: number;
+  indexBlockReadCount: number;
+  filterBlockReadCount: number;
+  getSnapshotNanos: number;
+  getFromMemtableNanos: number;
+  getFromMemtableCount: number;
+  getFromOutputFilesNanos: number;
+  seekOnMemtableNanos: number;
+  seekInternalSeekNanos: number;
+  findNextUserEntryNanos: number;
+  internalKeySkippedCount: number;
+  internalDeleteSkippedCount: number;
+  bloomMemtableHitCount: number;
+  bloomMemtableMissCount: number;
+  bloomSstHitCount: number;
+  bloomSstMissCount: number;
+  getReadBytes: number;
+  multiGetReadBytes: number;
+  iterReadBytes: number;
+  bytesRead: number;
+  readNanos: number;
+  bytesWritten: number;
+  writeNanos: number;
+  fsyncNanos: number;
+  openNanos: number;
+};
+
+/**
+ * Profiling option shared by reads
+ */
+type RocksDBPerfOption = {
+  /**
+   * Profiles the operation, the breakdown is written into this object
+   * before the operation completes
+   */
+  perf?: Partial<RocksDBPerfContext>; // Default undefined
 };
 
 /**
@@ -78,7 +363,7 @@ type RocksDBGetOptions<
   valueEncoding?: 'utf8' | 'buffer'; // Default 'utf8';
   fillCache?: boolean; // Default true
   snapshot?: S;
-};
+} & RocksDBColumnFamilyOption & RocksDBPerfOption;
 
 /**
  * Put options
@@ -92,7 +377,7 @@ type RocksDBPutOptions = {
    * This will amortize the cost of `fsync()` across the entire transaction
    */
   sync?: boolean; // Default false
-};
+} & RocksDBColumnFamilyOption;
 
 /**
  * Del options
@@ -109,7 +394,7 @@ type RocksDBRangeOptions = {
   lte?: string | Buffer;
   reverse?: boolean; // Default false
   limit?: number; // Default -1
-};
+} & RocksDBColumnFamilyOption;
 
 /**
  * Clear options
@@ -128,7 +413,18 @@ type RocksDBCountOptions<
   S extends RocksDBSnapshot | RocksDBTransactionSnapshot = RocksDBSnapshot,
 > = Omit<RocksDBRangeOptions, 'reverse'> & {
   snapshot?: S;
-};
+  /**
+   * Estimates the count from table properties without iterating
+   * For entries of similar sizes, the estimate is off by at most the keys
+   * of the range that are overwritten or deleted but not yet compacted,
+   * plus the keys of a data block at each end of the range
+   * Range deletions written by `dbClear` can hide any number of keys, the
+   * count is exact while they are in the memtables or in tables
+   * overlapping the range
+   * The snapshot is ignored, this is not available for transactions
+   */
+  estimate?: S extends RocksDBSnapshot ? boolean : void; // Default false
+} & RocksDBPerfOption;
 
 /**
  * Iterator options
@@ -141,28 +437,86 @@ type RocksDBIteratorOptions<
     values?: boolean;
     keyEncoding?: 'utf8' | 'buffer'; // Default 'utf8'
     highWaterMarkBytes?: number; // Default is 16 * 1024
+    keyPath?: boolean; // Default false, only applies to packed batches
+    /**
+     * Reads the next packed batch in the background
+     * Transaction iterators ignore this, because a prefetch would race with
+     * writes to the transaction
+     */
+    prefetch?: boolean; // Default false, requires packed batches
   };
 
 /**
  * Transaction options
  */
-type RocksDBTransactionOptions = RocksDBPutOptions;
+type RocksDBTransactionOptions = Omit<RocksDBPutOptions, 'columnFamily'>;
 
 /**
  * Batch options
  */
-type RocksDBBatchOptions = RocksDBPutOptions;
+type RocksDBBatchOptions = Omit<RocksDBPutOptions, 'columnFamily'>;
 
 type RocksDBBatchPutOperation = {
   type: 'put';
   key: string | Buffer;
   value: string | Buffer;
+} & RocksDBColumnFamilyOption;
+
+/**
+ * Summary of a RocksDB histogram
+ * Latencies are in microseconds
+ */
+type RocksDBHistogram = {
+  count: number;
+  sum: number;
+  min: number;
+  max: number;
+  average: number;
+  standardDeviation: number;
+  median: number;
+  percentile95: number;
+  percentile99: number;
+};
+
+/**
+ * RocksDB statistics keyed by their RocksDB names
+ * e.g. `rocksdb.block.cache.hit`, `rocksdb.bloom.filter.useful`,
+ * `rocksdb.stall.micros`, `rocksdb.db.get.micros`, `rocksdb.db.seek.micros`
+ */
+type RocksDBStatistics = {
+  tickers: Record<string, number>;
+  histograms: Record<string, RocksDBHistogram>;
+};
+
+/**
+ * Latency histogram of workers in microseconds
+ * `buckets[i]` counts latencies below `2 ** (i + 1)` microseconds, the last
+ * bucket counts everything above
+ */
+type RocksDBLatencyHistogram = {
+  count: number;
+  sum: number;
+  max: number;
+  buckets: Array<number>;
+};
+
+/**
+ * Latencies of the workers of a resource name such as `rocksdb.db.get`
+ * `queue` is the wait for a pool thread, `execute` is the time on the pool
+ * thread and `complete` is the time converting results and calling back on
+ * the main thread
+ * Gets served from the block cache on the main thread have no queue wait
+ */
+type RocksDBWorkerLatency = {
+  queue: RocksDBLatencyHistogram;
+  execute: RocksDBLatencyHistogram;
+  complete: RocksDBLatencyHistogram;
 };
 
 type RocksDBBatchDelOperation = {
   type: 'del';
   key: string | Buffer;
-};
+} & RocksDBColumnFamilyOption;
 
 export type {
   RocksDBDatabase,
@@ -171,7 +525,18 @@ export type {
   RocksDBBatch,
   RocksDBSnapshot,
   RocksDBTransactionSnapshot,
+  RocksDBColumnFamily,
+  RocksDBCache,
+  RocksDBWriteBufferManager,
+  RocksDBCompression,
+  RocksDBColumnFamilyOptions,
+  RocksDBCacheOptions,
+  RocksDBWriteBufferManagerOptions,
+  RocksDBWriteBufferManagerUsage,
   RocksDBDatabaseOptions,
+  RocksDBColumnFamilyOption,
+  RocksDBPerfContext,
+  RocksDBPerfOption,
   RocksDBGetOptions,
   RocksDBPutOptions,
   RocksDBDelOptions,
@@ -183,4 +548,8 @@ export type {
   RocksDBBatchOptions,
   RocksDBBatchDelOperation,
   RocksDBBatchPutOperation,
+  RocksDBHistogram,
+  RocksDBStatistics,
+  RocksDBLatencyHistogram,
+  RocksDBWorkerLatency,
 };
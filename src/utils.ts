@@ -1,5 +1,6 @@
 import type { Callback, Merge, KeyPath, LevelPath } from './types';
 import * as errors from './errors';
+import rocksdb from './native/rocksdb';
 
 /**
  * Separator is a single null byte
@@ -108,19 +109,10 @@ function toKeyPath(keyPath: KeyPath | string | Buffer): KeyPath {
  * An empty key path is converted to `['']`
  * Level parts is allowed to contain the separator
  * Key actual part is allowed to contain the separator
+ * The encoding is done natively, `encodePart` is the reference
  */
 function keyPathToKey(keyPath: KeyPath): Buffer {
-  if (keyPath.length < 1) {
-    keyPath = [''];
-  }
-  const keyPart = keyPath.slice(-1)[0];
-  const levelPath = keyPath.slice(0, -1);
-  return Buffer.concat([
-    levelPathToKey(levelPath),
-    encodePart(
-      typeof keyPart === 'string' ? Buffer.from(keyPart, 'utf-8') : keyPart,
-    ),
-  ]);
+  return rocksdb.keyPathToKey(keyPath);
 }
 
 /**
@@ -129,19 +121,14 @@ function keyPathToKey(keyPath: KeyPath): Buffer {
  * Level parts are allowed to contain the separator before encoding
  */
 function levelPathToKey(levelPath: LevelPath): Buffer {
-  return Buffer.concat(
-    levelPath.map((p) => {
-      p = typeof p === 'string' ? Buffer.from(p, 'utf-8') : p;
-      p = encodePart(p);
-      return Buffer.concat([sep, p, sep]);
-    }),
-  );
+  return rocksdb.levelPathToKey(levelPath);
 }
 
 /**
  * Converts key buffer back into KeyPath
  * e.g. !A!!B!C => ['A', 'B', 'C'] (where ! is the sep)
  * Returned parts are always buffers
+ * Throws `SyntaxError` if a part is not base 128 encoded
  *
  * BNF grammar of key buffer:
  *   path => levels:ls keyActual:k -> [...ls, k] | keyActual:k -> [k]
@@ -151,83 +138,7 @@ function levelPathToKey(levelPath: LevelPath): Buffer {
  *   keyActual => .*:k -> [k]
  */
 function parseKey(key: Buffer): KeyPath {
-  const [bufs] = parsePath(key);
-  if (bufs.length < 1) {
-    throw new TypeError('Buffer is not a key');
-  }
-  for (let i = 0; i < bufs.length; i++) {
-    bufs[i] = decodePart(bufs[i]);
-  }
-  return bufs;
-}
-
-function parsePath(input: Buffer): [Array<Buffer>, Buffer] {
-  try {
-    let output: Array<Buffer> = [];
-    let input_: Buffer = input;
-    let output_: Array<Buffer>;
-    [output_, input_] = parseLevels(input_);
-    output = output.concat(output_);
-    [output_, input_] = parseKeyActual(input_);
-    output = output.concat(output_);
-    return [output, input_];
-  } catch (e) {
-    let output: Array<Buffer> = [];
-    let input_: Buffer = input;
-    let output_: Array<Buffer>;
-    // eslint-disable-next-line prefer-const
-    [output_, input_] = parseKeyActual(input_);
-    output = output.concat(output_);
-    return [output, input_];
-  }
-}
-
-function parseLevels(
-  input: Buffer,
-): [output: Array<Buffer>, remaining: Buffer] {
-  let output: Array<Buffer> = [];
-  try {
-    let input_: Buffer = input;
-    let output_: Array<Buffer>;
-    [output_, input_] = parseLevel(input_);
-    output = output.concat(output_);
-    [output_, input_] = parseLevels(input_);
-    output = output.concat(output_);
-    return [output, input_];
-  } catch (e) {
-    return [[], input];
-  }
-}
-
-function parseLevel(input: Buffer): [Array<Buffer>, Buffer] {
-  const sepStart = input.indexOf(sep);
-  if (sepStart === -1) {
-    throw new errors.ErrorDBParseKey('Missing separator start');
-  }
-  let sepEnd: number | undefined;
-  const levelBytes: Array<number> = [];
-  const buf = input.subarray(sepStart + 1);
-  for (let i = 0; i < buf.byteLength; i++) {
-    const b = buf[i];
-    if (b === sep[0]) {
-      // Note that `buf` is a subarray offset from the input
-      // therefore the `sepEnd` must be offset by the same length
-      sepEnd = i + (sepStart + 1);
-      break;
-    } else {
-      levelBytes.push(b);
-    }
-  }
-  if (sepEnd == null) {
-    throw new errors.ErrorDBParseKey('Missing separator end');
-  }
-  const level = Buffer.from(levelBytes);
-  const remaining = input.subarray(sepEnd + 1);
-  return [[level], remaining];
-}
-
-function parseKeyActual(input: Buffer): [Array<Buffer>, Buffer] {
-  return [[input], input.subarray(input.byteLength)];
+  return rocksdb.parseKey(key);
 }
 
 /**
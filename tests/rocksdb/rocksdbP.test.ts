@@ -1,9 +1,17 @@
-import type { RocksDBDatabase } from '@/native/types';
+import type {
+  RocksDBCache,
+  RocksDBDatabase,
+  RocksDBDatabaseOptions,
+  RocksDBIterator,
+  RocksDBPerfContext,
+} from '@/native/types';
 import os from 'os';
 import path from 'path';
 import fs from 'fs';
 import { Barrier } from '@matrixai/async-locks';
+import rocksdb from '@/native/rocksdb';
 import rocksdbP from '@/native/rocksdbP';
+import * as testsUtils from '../utils';
 
 describe('rocksdbP', () => {
   let dataDir: string;
@@ -47,6 +55,422 @@ describe('rocksdbP', () => {
     await rocksdbP.iteratorClose(iterator);
     await rocksdbP.transactionRollback(tran);
   });
+  describe('open options', () => {
+    let dbPath: string;
+    let dbs: Array<RocksDBDatabase>;
+    beforeEach(async () => {
+      dbPath = `${dataDir}/db`;
+      dbs = [];
+    });
+    afterEach(async () => {
+      // Closing is idempotent, so tests can close databases themselves
+      for (const db of dbs) {
+        await rocksdbP.dbClose(db);
+      }
+    });
+    /**
+     * Opens a database that is closed after the test
+     */
+    const openDB = async (
+      options: RocksDBDatabaseOptions = {},
+      location: string = dbPath,
+    ): Promise<RocksDBDatabase> => {
+      const db = rocksdbP.dbInit();
+      await rocksdbP.dbOpen(db, location, options);
+      dbs.push(db);
+      return db;
+    };
+    test('dbOpen with prefixLevels iterates across and within levels', async () => {
+      const db = await openDB({ prefixLevels: 1 });
+      const keyPaths = [
+        ['a', '1'],
+        ['a', '2'],
+        ['a', 'b', '3'],
+        ['b', '4'],
+        ['5'],
+      ];
+      const keys = keyPaths.map((keyPath) => rocksdbP.keyPathToKey(keyPath));
+      for (const key of keys) {
+        await rocksdbP.dbPut(db, key, 'v', {});
+      }
+      const iterate = async (options) => {
+        const iter = rocksdbP.iteratorInit(db, {
+          ...options,
+          keyEncoding: 'buffer',
+        });
+        const [entries] = await rocksdbP.iteratorNextv(iter, 10);
+        await rocksdbP.iteratorClose(iter);
+        return entries.map(([k]) => k);
+      };
+      const sorted = [...keys].sort(Buffer.compare);
+      expect(await iterate({})).toEqual(sorted);
+      expect(await iterate({ reverse: true })).toEqual([...sorted].reverse());
+      for (const levelPath of [['a'], ['a', 'b'], ['b']]) {
+        const gt = rocksdbP.levelPathToKey(levelPath);
+        const lt = Buffer.from(gt);
+        lt[lt.length - 1] += 1;
+        const expected = sorted.filter(
+          (k) => Buffer.compare(k, gt) > 0 && Buffer.compare(k, lt) < 0,
+        );
+        expect(expected.length).toBeGreaterThan(0);
+        expect(await iterate({ gt, lt })).toEqual(expected);
+        expect(await iterate({ gt, lt, reverse: true })).toEqual(
+          [...expected].reverse(),
+        );
+      }
+    });
+    test('dbOpen with columnFamilies routes operations and drops them', async () => {
+      const db = await openDB({
+        columnFamilies: { hot: { writeBufferSize: 1024 * 1024 } },
+      });
+      const columnFamily = rocksdbP.dbColumnFamily(db, 'hot')!;
+      expect(columnFamily).toBeDefined();
+      expect(rocksdbP.dbColumnFamily(db, 'cold')).toBeUndefined();
+      await rocksdbP.dbPut(db, 'foo', 'hot', { columnFamily });
+      await rocksdbP.dbPut(db, 'foo', 'default', {});
+      expect(await rocksdbP.dbGet(db, 'foo', { columnFamily })).toBe('hot');
+      expect(await rocksdbP.dbGet(db, 'foo', {})).toBe('default');
+      await rocksdbP.batchDo(
+        db,
+        [{ type: 'put', key: 'bar', value: 'hot', columnFamily }],
+        {},
+      );
+      const tran = rocksdbP.transactionInit(db, {});
+      await rocksdbP.transactionPut(tran, 'baz', 'hot', { columnFamily });
+      await rocksdbP.transactionCommit(tran);
+      expect(await rocksdbP.dbCount(db, { columnFamily })).toBe(3);
+      expect(await rocksdbP.dbCount(db, {})).toBe(1);
+      const iter = rocksdbP.iteratorInit(db, { columnFamily });
+      const [entries] = await rocksdbP.iteratorNextv(iter, 10);
+      await rocksdbP.iteratorClose(iter);
+      expect(entries).toEqual([
+        ['bar', 'hot'],
+        ['baz', 'hot'],
+        ['foo', 'hot'],
+      ]);
+      // Column families cannot be used with other databases
+      const dbOther = await openDB({}, `${dataDir}/dbOther`);
+      await expect(
+        rocksdbP.dbPut(dbOther, 'foo', 'hot', { columnFamily }),
+      ).rejects.toHaveProperty('code', 'COLUMN_FAMILY_INVALID');
+      expect(() => rocksdbP.iteratorInit(dbOther, { columnFamily })).toThrow(
+        'Column family does not belong to the database',
+      );
+      await expect(
+        rocksdbP.dbDropColumnFamily(dbOther, columnFamily),
+      ).rejects.toHaveProperty('code', 'COLUMN_FAMILY_INVALID');
+      await rocksdbP.dbDropColumnFamily(db, columnFamily);
+      expect(rocksdbP.dbColumnFamily(db, 'hot')).toBeUndefined();
+      await rocksdbP.dbClose(db);
+      // Dropped column families are gone when reopening
+      const db_ = await openDB();
+      expect(rocksdbP.dbColumnFamily(db_, 'hot')).toBeUndefined();
+      expect(await rocksdbP.dbGet(db_, 'foo', {})).toBe('default');
+      // Column families of the closed database are not valid either
+      await expect(
+        rocksdbP.dbGet(db_, 'foo', { columnFamily }),
+      ).rejects.toHaveProperty('code', 'COLUMN_FAMILY_INVALID');
+    });
+    test.each([
+      [{}],
+      [{ workerThreads: 0 }],
+      [{ workerThreads: 1, longWorkerThreads: 0 }],
+    ])('dbOpen with executor options %j', async (options) => {
+      const db = await openDB(options);
+      const keys = Array.from({ length: 100 }, (_, i) => `key${i}`);
+      // Short and long running workers are in flight at the same time
+      await Promise.all([
+        ...keys.map((key) => rocksdbP.dbPut(db, key, key, {})),
+        rocksdbP.dbCompactRange(db, 'key0', 'key99'),
+      ]);
+      expect(await rocksdbP.dbMultiGet(db, keys, {})).toEqual(keys);
+      const [count] = await Promise.all([
+        rocksdbP.dbCount(db, {}),
+        rocksdbP.dbGet(db, 'key0', {}),
+      ]);
+      expect(count).toBe(100);
+      await rocksdbP.dbClear(db, {});
+      expect(await rocksdbP.dbCount(db, {})).toBe(0);
+      await rocksdbP.dbClose(db);
+      // Closing stops the executor, a reopened database starts its own
+      const db_ = await openDB(options);
+      expect(await rocksdbP.dbCount(db_, {})).toBe(0);
+    });
+    test.each([
+      [{ pipelinedWrite: true, maxWriteBufferNumber: 4 }],
+      [{ concurrentMemtableWrite: false, minWriteBufferNumberToMerge: 2 }],
+    ])('dbOpen with write options %j', async (options) => {
+      const db = await openDB(options);
+      await Promise.all(
+        Array.from({ length: 100 }, (_, i) =>
+          rocksdbP.dbPut(db, `key${i}`, `value${i}`, {}),
+        ),
+      );
+      expect(await rocksdbP.dbCount(db, {})).toBe(100);
+    });
+    test('dbOpen rejects unordered writes', async () => {
+      await expect(
+        openDB({
+          // @ts-expect-error: unordered writes break transaction isolation
+          unorderedWrite: true,
+        }),
+      ).rejects.toHaveProperty('code', 'DB_OPEN');
+    });
+    test('dbGetStatistics returns tickers and histograms', async () => {
+      const db = await openDB();
+      expect(rocksdbP.dbGetStatistics(db)).toBeUndefined();
+      await rocksdbP.dbClose(db);
+      const db_ = await openDB({ statistics: true });
+      await rocksdbP.dbPut(db_, 'foo', 'bar', {});
+      expect(await rocksdbP.dbGet(db_, 'foo', {})).toBe('bar');
+      const statistics = rocksdbP.dbGetStatistics(db_)!;
+      expect(statistics.tickers['rocksdb.number.keys.written']).toBe(1);
+      expect(statistics.tickers['rocksdb.number.keys.read']).toBe(1);
+      expect(statistics.histograms['rocksdb.db.get.micros'].count).toBe(1);
+      expect(statistics.histograms['rocksdb.db.write.micros'].count).toBe(1);
+      rocksdbP.dbResetStatistics(db_);
+      expect(
+        rocksdbP.dbGetStatistics(db_)!.tickers['rocksdb.number.keys.written'],
+      ).toBe(0);
+    });
+    test('dbOpen shares a cache and takes sizes past 4 GiB', async () => {
+      const size = 5 * 1024 ** 3;
+      const cache = rocksdbP.cacheInit({ size, shardBits: 4 });
+      const db1 = await openDB({ cache }, `${dataDir}/db1`);
+      // The shared cache takes precedence over `cacheSize`
+      const db2 = await openDB({ cache, cacheSize: 1024 }, `${dataDir}/db2`);
+      const db3 = await openDB(
+        { cacheSize: size, maxFileSize: size },
+        `${dataDir}/db3`,
+      );
+      for (const db of [db1, db2, db3]) {
+        expect(rocksdbP.dbGetProperty(db, 'rocksdb.block-cache-capacity')).toBe(
+          `${size}`,
+        );
+      }
+      await rocksdbP.dbPut(db1, 'foo', 'bar', {});
+      await rocksdbP.dbCompactRange(db1, 'foo', 'foo');
+      expect(await rocksdbP.dbGet(db1, 'foo', {})).toBe('bar');
+      // Blocks cached by one database count against the others
+      expect(rocksdbP.dbGetProperty(db2, 'rocksdb.block-cache-usage')).not.toBe(
+        '0',
+      );
+      expect(rocksdbP.dbGetProperty(db3, 'rocksdb.block-cache-usage')).toBe(
+        '0',
+      );
+      // Clock caches depend on how the bundled RocksDB was built
+      let clockCache: RocksDBCache | undefined;
+      let clockError: unknown;
+      try {
+        clockCache = rocksdbP.cacheInit({ size, type: 'clock' });
+      } catch (e) {
+        clockError = e;
+      }
+      if (clockCache == null) {
+        expect(clockError).toHaveProperty('code', 'CACHE_UNSUPPORTED');
+      } else {
+        expect(clockError).toBeUndefined();
+        const db4 = await openDB({ cache: clockCache }, `${dataDir}/db4`);
+        expect(
+          rocksdbP.dbGetProperty(db4, 'rocksdb.block-cache-capacity'),
+        ).toBe(`${size}`);
+      }
+    });
+    test('dbOpen shares a write buffer manager across databases', async () => {
+      const size = 1024 * 1024;
+      const cache = rocksdbP.cacheInit({ size: 16 * 1024 * 1024 });
+      const writeBufferManager = rocksdbP.writeBufferManagerInit({
+        size,
+        cache,
+      });
+      const db1 = await openDB({ cache, writeBufferManager }, `${dataDir}/db1`);
+      const db2 = await openDB({ cache, writeBufferManager }, `${dataDir}/db2`);
+      await rocksdbP.dbPut(db2, 'foo', 'bar', {});
+      const usage = rocksdbP.writeBufferManagerUsage(writeBufferManager);
+      expect(usage.size).toBe(size);
+      expect(usage.usage).toBeGreaterThan(0);
+      // Twice the budget is written, which is well below `writeBufferSize`
+      const value = Buffer.alloc(8 * 1024, 'v');
+      for (let i = 0; i < (2 * size) / value.length; i++) {
+        await rocksdbP.dbPut(db1, `key${i}`, value, {});
+      }
+      // Flushes run in the background
+      for (let i = 0; i < 100; i++) {
+        if (
+          rocksdbP.dbGetProperty(db1, 'rocksdb.num-files-at-level0') !== '0'
+        ) {
+          break;
+        }
+        await new Promise((resolve) => setTimeout(resolve, 10));
+      }
+      expect(
+        rocksdbP.dbGetProperty(db1, 'rocksdb.num-files-at-level0'),
+      ).not.toBe('0');
+    });
+    test('dbOpen with table options reads back flushed tables', async () => {
+      const db = await openDB({
+        partitionedIndexFilters: true,
+        cacheIndexAndFilterBlocks: true,
+        pinL0FilterAndIndexBlocks: true,
+        dataBlockHashIndex: true,
+        formatVersion: 5,
+        columnFamilies: { plain: { filterBitsPerKey: 0, formatVersion: 2 } },
+      });
+      const columnFamily = rocksdbP.dbColumnFamily(db, 'plain')!;
+      const keys = Array.from({ length: 1000 }, (_, i) => `key${i}`);
+      for (const key of keys) {
+        await rocksdbP.dbPut(db, key, key, {});
+        await rocksdbP.dbPut(db, key, key, { columnFamily });
+      }
+      await rocksdbP.dbCompactRange(db, 'key0', 'key999');
+      // Index and filter blocks of the new tables are in the block cache
+      expect(rocksdbP.dbGetProperty(db, 'rocksdb.block-cache-usage')).not.toBe(
+        '0',
+      );
+      expect(await rocksdbP.dbMultiGet(db, keys, {})).toEqual(keys);
+      expect(await rocksdbP.dbGet(db, 'key500', { columnFamily })).toBe(
+        'key500',
+      );
+      await expect(rocksdbP.dbGet(db, 'missing', {})).rejects.toHaveProperty(
+        'code',
+        'NOT_FOUND',
+      );
+      expect(await rocksdbP.dbCount(db, { columnFamily })).toBe(1000);
+    });
+    test('dbOpen with ribbon filters skips tables on missing keys', async () => {
+      const db = await openDB({
+        statistics: true,
+        filterPolicy: 'ribbon',
+        formatVersion: 5,
+      });
+      const keys = Array.from({ length: 1000 }, (_, i) => `key${i}`);
+      for (const key of keys) {
+        await rocksdbP.dbPut(db, key, key, {});
+      }
+      await rocksdbP.dbCompactRange(db, 'key0', 'key999');
+      expect(await rocksdbP.dbMultiGet(db, keys, {})).toEqual(keys);
+      // Missing keys within the range of the table
+      for (const key of keys) {
+        await expect(rocksdbP.dbGet(db, `${key}x`, {})).rejects.toHaveProperty(
+          'code',
+          'NOT_FOUND',
+        );
+      }
+      const { tickers } = rocksdbP.dbGetStatistics(db)!;
+      expect(tickers['rocksdb.bloom.filter.useful']).toBeGreaterThan(0);
+    });
+    test('dbOpen invalid filter policy option', async () => {
+      const db = rocksdbP.dbInit();
+      await expect(
+        rocksdbP.dbOpen(db, dbPath, {
+          // @ts-ignore use incorrect value
+          filterPolicy: 'cuckoo',
+        }),
+      ).rejects.toHaveProperty('code', 'DB_OPEN');
+    });
+    test.each(['none', 'snappy', 'lz4', 'lz4hc', 'zstd'] as const)(
+      'dbOpen with %s compression reads back compacted tables',
+      async (compression) => {
+        const db = await openDB({
+          compression,
+          compressionPerLevel: ['none', compression],
+          bottommostCompression: 'zstd',
+          compressionDictBytes: 16 * 1024,
+          compressionDictTrainBytes: 64 * 1024,
+        });
+        const keys = Array.from({ length: 1000 }, (_, i) => `key${i}`);
+        const values = keys.map((key) => JSON.stringify({ key, tags: [key] }));
+        for (let i = 0; i < keys.length; i++) {
+          await rocksdbP.dbPut(db, keys[i], values[i], {});
+        }
+        await rocksdbP.dbCompactRange(db, 'key0', 'key999');
+        expect(await rocksdbP.dbMultiGet(db, keys, {})).toEqual(values);
+      },
+    );
+    test.each([
+      { compression: 'zstandard' },
+      { compressionPerLevel: ['none', 'zstandard'] },
+      { bottommostCompression: 1 },
+      { blobCompression: 'zstandard' },
+      { columnFamilies: { other: { compression: 'zstandard' } } },
+    ])('dbOpen invalid compression option %j', async (options) => {
+      const db = rocksdbP.dbInit();
+      await expect(
+        // @ts-ignore use incorrect value
+        rocksdbP.dbOpen(db, dbPath, options),
+      ).rejects.toHaveProperty('code', 'DB_OPEN');
+    });
+    test('dbOpen with blob files separates large values', async () => {
+      const db = await openDB({
+        enableBlobFiles: true,
+        minBlobSize: 1024,
+        blobCompression: 'lz4',
+        enableBlobGarbageCollection: true,
+        blobGarbageCollectionAgeCutoff: 0.5,
+      });
+      const large = Buffer.alloc(64 * 1024, 'l');
+      await rocksdbP.dbPut(db, 'large', large, {});
+      await rocksdbP.dbPut(db, 'small', 'small', {});
+      await rocksdbP.dbCompactRange(db, 'large', 'small');
+      const files = await fs.promises.readdir(dbPath);
+      expect(files.some((file) => file.endsWith('.blob'))).toBe(true);
+      expect(
+        await rocksdbP.dbGet(db, 'large', { valueEncoding: 'buffer' }),
+      ).toEqual(large);
+      expect(await rocksdbP.dbGet(db, 'small', {})).toBe('small');
+    });
+  });
+  describe('group commit', () => {
+    let dbPath: string;
+    let db: RocksDBDatabase;
+    beforeEach(async () => {
+      dbPath = `${dataDir}/db`;
+      db = rocksdbP.dbInit();
+      await rocksdbP.dbOpen(db, dbPath, {
+        statistics: true,
+        columnFamilies: { other: {} },
+      });
+    });
+    afterEach(async () => {
+      await rocksdbP.dbClose(db);
+    });
+    test('concurrent synchronous writes are group committed', async () => {
+      const columnFamily = rocksdbP.dbColumnFamily(db, 'other')!;
+      const walSynced = () =>
+        rocksdbP.dbGetStatistics(db)!.tickers['rocksdb.wal.synced'];
+      const keys = Array.from({ length: 100 }, (_, i) => `key${i}`);
+      await Promise.all(
+        keys.map((key) => rocksdbP.dbPut(db, key, key, { sync: true })),
+      );
+      // Writes queued while a group is synced share the next sync
+      expect(walSynced()).toBeGreaterThan(0);
+      expect(walSynced()).toBeLessThan(keys.length / 4);
+      rocksdbP.dbResetStatistics(db);
+      // Each write resolves on its own, whichever group it was written in
+      const results = await Promise.all([
+        ...keys
+          .slice(0, 50)
+          .map((key) => rocksdbP.dbDel(db, key, { sync: true })),
+        ...keys.map((key) =>
+          rocksdbP.batchDo(
+            db,
+            [
+              { type: 'put', key, value: 'other', columnFamily },
+              { type: 'del', key: `${key}x` },
+            ],
+            { sync: true },
+          ),
+        ),
+        rocksdbP.dbPut(db, 'async', 'async', {}),
+      ]);
+      expect(results).toHaveLength(151);
+      expect(walSynced()).toBeLessThan(150 / 4);
+      expect(await rocksdbP.dbCount(db, {})).toBe(51);
+      expect(await rocksdbP.dbCount(db, { columnFamily })).toBe(100);
+      expect(await rocksdbP.dbGet(db, 'key50', {})).toBe('key50');
+      expect(await rocksdbP.dbGet(db, 'key0', { columnFamily })).toBe('other');
+    });
+  });
   describe('database', () => {
     let dbPath: string;
     let db: RocksDBDatabase;
@@ -58,6 +482,90 @@ describe('rocksdbP', () => {
     afterEach(async () => {
       await rocksdbP.dbClose(db);
     });
+    test('reads with perf write their breakdown into the perf object', async () => {
+      await rocksdbP.dbPut(db, 'foo', 'bar', {});
+      await rocksdbP.dbDel(db, 'baz', {});
+      const getPerf: Partial<RocksDBPerfContext> = {};
+      expect(await rocksdbP.dbGet(db, 'foo', { perf: getPerf })).toBe('bar');
+      expect(getPerf.getFromMemtableCount).toBe(1);
+      expect(getPerf.getReadBytes).toBe(3);
+      const iterPerf: Partial<RocksDBPerfContext> = {};
+      const iterator = rocksdbP.iteratorInit(db, {});
+      const [entries] = await rocksdbP.iteratorNextv(iterator, 10, {
+        perf: iterPerf,
+      });
+      await rocksdbP.iteratorClose(iterator);
+      expect(entries).toEqual([['foo', 'bar']]);
+      expect(iterPerf.internalDeleteSkippedCount).toBe(1);
+      expect(iterPerf.iterReadBytes).toBeGreaterThan(0);
+      const countPerf: Partial<RocksDBPerfContext> = {};
+      expect(await rocksdbP.dbCount(db, { perf: countPerf })).toBe(1);
+      expect(countPerf.internalDeleteSkippedCount).toBe(1);
+    });
+    test('workerLatencies records each stage per resource name', async () => {
+      const before =
+        rocksdbP.workerLatencies()['rocksdb.db.put']?.execute.count;
+      await rocksdbP.dbPut(db, 'foo', 'bar', {});
+      await rocksdbP.dbPut(db, 'foo', 'bar', {});
+      const latency = rocksdbP.workerLatencies()['rocksdb.db.put'];
+      expect(latency.execute.count).toBe((before ?? 0) + 2);
+      for (const histogram of [
+        latency.queue,
+        latency.execute,
+        latency.complete,
+      ]) {
+        expect(histogram.buckets).toHaveLength(32);
+        expect(histogram.buckets.reduce((a, b) => a + b)).toBe(histogram.count);
+        expect(histogram.max).toBeLessThanOrEqual(histogram.sum);
+      }
+      expect(rocksdbP.workerLatencies()['rocksdb.db.open']).toBeDefined();
+      // Transaction counts are recorded as counts
+      const counts = () => {
+        const latency = rocksdbP.workerLatencies()['rocksdb.iterator.count'];
+        return latency?.execute.count ?? 0;
+      };
+      const countsBefore = counts();
+      const tran = rocksdbP.transactionInit(db, {});
+      await rocksdbP.transactionCount(tran, {});
+      await rocksdbP.transactionRollback(tran);
+      expect(counts()).toBe(countsBefore + 1);
+    });
+    test('dbGet and transactionGet call back early from the block cache', async () => {
+      await rocksdbP.dbPut(db, 'foo', 'bar', {});
+      let value: string | undefined;
+      rocksdb.dbGet(db, 'foo', {}, (e, v) => {
+        value = v;
+      });
+      expect(value).toBe('bar');
+      // Compaction flushes the memtable, the new table's blocks are not cached
+      await rocksdbP.dbCompactRange(db, 'foo', 'foo');
+      value = undefined;
+      const read = new Promise<void>((resolve) => {
+        rocksdb.dbGet(db, 'foo', {}, (e, v) => {
+          value = v;
+          resolve();
+        });
+      });
+      expect(value).toBeUndefined();
+      await read;
+      expect(value).toBe('bar');
+      value = undefined;
+      rocksdb.dbGet(db, 'foo', {}, (e, v) => {
+        value = v;
+      });
+      expect(value).toBe('bar');
+      const tran = rocksdbP.transactionInit(db, {});
+      value = undefined;
+      rocksdb.transactionGet(tran, 'foo', {}, (e, v) => {
+        value = v;
+      });
+      expect(value).toBe('bar');
+      await expect(rocksdbP.dbGet(db, 'missing', {})).rejects.toHaveProperty(
+        'code',
+        'NOT_FOUND',
+      );
+      await rocksdbP.transactionRollback(tran);
+    });
     test('dbMultiGet', async () => {
       await rocksdbP.dbPut(db, 'foo', 'bar', {});
       await rocksdbP.dbPut(db, 'bar', 'foo', {});
@@ -67,6 +575,14 @@ describe('rocksdbP', () => {
         undefined,
       ]);
     });
+    test('dbMultiGet returns values in the order of the keys', async () => {
+      await rocksdbP.dbPut(db, 'a', '1', {});
+      await rocksdbP.dbPut(db, 'b', '2', {});
+      await rocksdbP.dbPut(db, 'c', '3', {});
+      expect(
+        await rocksdbP.dbMultiGet(db, ['c', 'x', 'a', 'b', 'a'], {}),
+      ).toEqual(['3', undefined, '1', '2', '1']);
+    });
     test('dbGet and dbMultiget with snapshots', async () => {
       await rocksdbP.dbPut(db, 'K1', '100', {});
       await rocksdbP.dbPut(db, 'K2', '100', {});
@@ -88,6 +604,32 @@ describe('rocksdbP', () => {
       ]);
       await rocksdbP.snapshotRelease(snap);
     });
+    test('dbGet, dbMultiGet and iteratorNextv with large values', async () => {
+      const small = Buffer.alloc(16, 1);
+      const large = Buffer.alloc(1024 * 1024, 2);
+      await rocksdbP.dbPut(db, 'K1', small, {});
+      await rocksdbP.dbPut(db, 'K2', large, {});
+      expect(
+        await rocksdbP.dbGet(db, 'K2', { valueEncoding: 'buffer' }),
+      ).toEqual(large);
+      expect(
+        await rocksdbP.dbMultiGet(db, ['K1', 'K2'], {
+          valueEncoding: 'buffer',
+        }),
+      ).toEqual([small, large]);
+      const it = rocksdbP.iteratorInit(db, {
+        keyEncoding: 'buffer',
+        valueEncoding: 'buffer',
+      });
+      expect(await rocksdbP.iteratorNextv(it, 2)).toEqual([
+        [
+          [Buffer.from('K1'), small],
+          [Buffer.from('K2'), large],
+        ],
+        false,
+      ]);
+      await rocksdbP.iteratorClose(it);
+    });
     describe('iterators', () => {
       test('iteratorClose is idempotent', async () => {
         const it = rocksdbP.iteratorInit(db, {});
@@ -126,6 +668,138 @@ describe('rocksdbP', () => {
         expect(await rocksdbP.iteratorNextv(iter3, 1)).toEqual([[], true]);
         await rocksdbP.iteratorClose(iter3);
       });
+      test('iteratorNextvPacked returns a packed batch', async () => {
+        await rocksdbP.dbPut(db, 'K1', '100', {});
+        await rocksdbP.dbPut(db, 'K22', '2000', {});
+        const iter = rocksdbP.iteratorInit(db, {});
+        const [data, offsets, finished] = await rocksdbP.iteratorNextvPacked(
+          iter,
+          2,
+        );
+        expect(data).toEqual(Buffer.from('K1100K222000'));
+        expect(Array.from(offsets)).toEqual([2, 5, 8, 12]);
+        expect(finished).toBe(false);
+        expect(await rocksdbP.iteratorNextvPacked(iter, 2)).toEqual([
+          Buffer.alloc(0),
+          new Uint32Array(0),
+          true,
+        ]);
+        await rocksdbP.iteratorClose(iter);
+      });
+      test('iteratorInit with exclusive and inclusive bounds', async () => {
+        const k1 = Buffer.from('K1');
+        const k1Sep = Buffer.from('K1\x00');
+        const k10 = Buffer.from('K10');
+        for (const k of [k1, k1Sep, k10]) {
+          await rocksdbP.dbPut(db, k, 'v', {});
+        }
+        const keys = async (options) => {
+          const iter = rocksdbP.iteratorInit(db, {
+            ...options,
+            keyEncoding: 'buffer',
+          });
+          const [entries] = await rocksdbP.iteratorNextv(iter, 10);
+          await rocksdbP.iteratorClose(iter);
+          return entries.map(([k]) => k);
+        };
+        expect(await keys({ gt: k1 })).toEqual([k1Sep, k10]);
+        expect(await keys({ gte: k1Sep })).toEqual([k1Sep, k10]);
+        expect(await keys({ lte: k1 })).toEqual([k1]);
+        expect(await keys({ lt: k10 })).toEqual([k1, k1Sep]);
+        expect(await keys({ gt: k1, lte: k1Sep })).toEqual([k1Sep]);
+        expect(await keys({ lte: k1Sep, reverse: true })).toEqual([k1Sep, k1]);
+      });
+      test('iteratorNextvPacked with prefetch', async () => {
+        const keys = Array.from({ length: 100 }, (_, i) =>
+          i.toString().padStart(3, '0'),
+        );
+        for (const k of keys) {
+          await rocksdbP.dbPut(db, k, k, {});
+        }
+        const iter = rocksdbP.iteratorInit(db, { prefetch: true });
+        const readAll = async () => {
+          const entries: Array<string> = [];
+          let finished = false;
+          while (!finished) {
+            let data: Buffer, offsets: Uint32Array;
+            [data, offsets, finished] = await rocksdbP.iteratorNextvPacked(
+              iter,
+              10,
+            );
+            expect(offsets.length).toBeLessThanOrEqual(20);
+            for (let i = 0; i < offsets.length; i += 2) {
+              const keyStart = i === 0 ? 0 : offsets[i - 1];
+              entries.push(data.subarray(keyStart, offsets[i]).toString());
+            }
+          }
+          return entries;
+        };
+        expect(await readAll()).toEqual(keys);
+        // Seeking discards anything that was prefetched
+        rocksdbP.iteratorSeek(iter, '050');
+        expect(await readAll()).toEqual(keys.slice(50));
+        await expect(rocksdbP.iteratorNextv(iter, 1)).rejects.toHaveProperty(
+          'code',
+          'ITERATOR_PREFETCH',
+        );
+        await rocksdbP.iteratorClose(iter);
+      });
+      describe('seeking past a key that is not a KeyPath', () => {
+        // Not Base128, sorted between the KeyPaths of 'a' and 'x'
+        const badKey = Buffer.from([0x35, 0xff]);
+        const keys = ['a', 'x', 'y', 'z'];
+        let iter: RocksDBIterator<Buffer, Buffer>;
+        beforeEach(async () => {
+          for (const k of keys) {
+            await rocksdbP.dbPut(db, rocksdbP.keyPathToKey([k]), k, {});
+          }
+          await rocksdbP.dbPut(db, badKey, 'bad', {});
+          iter = rocksdbP.iteratorInit(db, {
+            keyEncoding: 'buffer',
+            valueEncoding: 'buffer',
+            keyPath: true,
+            prefetch: true,
+          });
+        });
+        afterEach(async () => {
+          await rocksdbP.iteratorClose(iter);
+        });
+        /**
+         * Values of the entries, one entry per batch so there is
+         * always a prefetch after the first batch
+         */
+        const readValues = async () => {
+          const values: Array<string> = [];
+          let finished = false;
+          while (!finished) {
+            let data: Buffer, offsets: Uint32Array;
+            [data, offsets, finished] = await rocksdbP.iteratorNextvPacked(
+              iter,
+              1,
+            );
+            if (offsets.length > 0) {
+              const valueStart = offsets[offsets.length - 2];
+              values.push(data.subarray(valueStart).toString());
+            }
+          }
+          return values;
+        };
+        test('while the prefetch of it is in flight', async () => {
+          const [, , finished] = await rocksdbP.iteratorNextvPacked(iter, 1);
+          expect(finished).toBe(false);
+          // The prefetch of the bad key has started and not yet finished
+          rocksdbP.iteratorSeek(iter, rocksdbP.keyPathToKey(['x']));
+          expect(await readValues()).toEqual(['x', 'y', 'z']);
+        });
+        test('after the prefetch of it has failed', async () => {
+          const [, , finished] = await rocksdbP.iteratorNextvPacked(iter, 1);
+          expect(finished).toBe(false);
+          // The failed prefetch is never delivered
+          await testsUtils.sleep(100);
+          rocksdbP.iteratorSeek(iter, rocksdbP.keyPathToKey(['x']));
+          expect(await readValues()).toEqual(['x', 'y', 'z']);
+        });
+      });
       test('iteratorInit with implicit snapshot', async () => {
         await rocksdbP.dbPut(db, 'K1', '100', {});
         await rocksdbP.dbPut(db, 'K2', '100', {});
@@ -188,6 +862,63 @@ describe('rocksdbP', () => {
           'NOT_FOUND',
         );
       });
+      test('dbClear with ranges', async () => {
+        for (const k of ['K1', 'K2', 'K3', 'K4', 'K5']) {
+          await rocksdbP.dbPut(db, k, '100', {});
+        }
+        await rocksdbP.dbClear(db, { gt: 'K1', lte: 'K2' });
+        await rocksdbP.dbClear(db, { gte: 'K4' });
+        const iter = rocksdbP.iteratorInit(db, {});
+        const [entries] = await rocksdbP.iteratorNextv(iter, 10);
+        await rocksdbP.iteratorClose(iter);
+        expect(entries).toEqual([
+          ['K1', '100'],
+          ['K3', '100'],
+        ]);
+        // Clearing an empty range is a noop
+        await rocksdbP.dbClear(db, { gt: 'K5' });
+        await rocksdbP.dbClear(db, { gte: 'K3', lt: 'K3' });
+        expect(await rocksdbP.dbCount(db, {})).toBe(2);
+      });
+      test('dbCount with estimate', async () => {
+        const value = Buffer.alloc(100, 'v');
+        for (let i = 0; i < 1000; i++) {
+          const key = `K${i.toString().padStart(4, '0')}`;
+          await rocksdbP.dbPut(db, key, value, {});
+        }
+        // Compaction moves the keys from the memtable into table files
+        await rocksdbP.dbCompactRange(db, 'K', 'L');
+        expect(await rocksdbP.dbCount(db, {})).toBe(1000);
+        const estimate = await rocksdbP.dbCount(db, { estimate: true });
+        expect(estimate).toBeGreaterThan(500);
+        expect(estimate).toBeLessThan(1500);
+        expect(
+          await rocksdbP.dbCount(db, { estimate: true, limit: 10 }),
+        ).toBeLessThanOrEqual(10);
+        expect(
+          await rocksdbP.dbCount(db, { estimate: true, gt: 'L' }),
+        ).toBe(0);
+      });
+      test('dbCount with estimate after dbClear', async () => {
+        const value = Buffer.alloc(100, 'v');
+        for (let i = 0; i < 1000; i++) {
+          const key = `K${i.toString().padStart(4, '0')}`;
+          await rocksdbP.dbPut(db, key, value, {});
+        }
+        await rocksdbP.dbCompactRange(db, 'K', 'L');
+        expect(
+          await rocksdbP.dbCount(db, { estimate: true, gte: 'K0500' }),
+        ).toBeGreaterThan(250);
+        // The cleared keys are still in the tables, the range deletion is
+        // only in the memtable
+        await rocksdbP.dbClear(db, { gte: 'K0500' });
+        expect(
+          await rocksdbP.dbCount(db, { estimate: true, gte: 'K0500' }),
+        ).toBe(0);
+        expect(
+          await rocksdbP.dbCount(db, { estimate: true, lt: 'K0500' }),
+        ).toBe(500);
+      });
       test('dbClear with explicit snapshot', async () => {
         await rocksdbP.dbPut(db, 'K1', '100', {});
         await rocksdbP.dbPut(db, 'K2', '100', {});
@@ -396,6 +1127,22 @@ describe('rocksdbP', () => {
         await rocksdbP.iteratorClose(iter);
         await rocksdbP.transactionRollback(tran);
       });
+      test('transactionIteratorInit ignores prefetch', async () => {
+        for (const k of ['K1', 'K2', 'K3']) {
+          await rocksdbP.dbPut(db, k, '100', {});
+        }
+        const tran = rocksdbP.transactionInit(db, {});
+        const iter = rocksdbP.transactionIteratorInit(tran, { prefetch: true });
+        // Writes during iteration never overlap with a prefetch
+        // They sort before the iterator, so it does not return them
+        for (const k of ['K1', 'K2', 'K3']) {
+          const [[[key]]] = await rocksdbP.iteratorNextv(iter, 1);
+          expect(key).toBe(k);
+          await rocksdbP.transactionPut(tran, `A${k}`, '200');
+        }
+        await rocksdbP.iteratorClose(iter);
+        await rocksdbP.transactionRollback(tran);
+      });
       test('transactionGetForUpdate does not block transactions', async () => {
         await rocksdbP.dbPut(db, 'K1', '100', {});
         await rocksdbP.dbPut(db, 'K2', '100', {});
@@ -167,6 +167,35 @@ describe('utils', () => {
       expect([i, utils.decodePart(pE)]).toStrictEqual(parts[j]);
     }
   });
+  test('native key paths match the base128 encoding', () => {
+    for (let i = 0; i < 1000; i++) {
+      const keyPath: Array<Buffer> = Array.from(
+        { length: testUtils.getRandomInt(1, 5) },
+        () => nodeCrypto.randomBytes(testUtils.getRandomInt(0, 101)),
+      );
+      const levelPath = keyPath.slice(0, -1);
+      const levelKey = Buffer.concat(
+        levelPath.map((p) =>
+          Buffer.concat([utils.sep, utils.encodePart(p), utils.sep]),
+        ),
+      );
+      const key = Buffer.concat([
+        levelKey,
+        utils.encodePart(keyPath[keyPath.length - 1]),
+      ]);
+      expect(utils.keyPathToKey(keyPath)).toStrictEqual(key);
+      expect(utils.levelPathToKey(levelPath)).toStrictEqual(levelKey);
+      expect(utils.parseKey(key)).toStrictEqual(keyPath);
+    }
+  });
+  test('parse key with non-base128 characters', () => {
+    expect(() =>
+      utils.parseKey(Buffer.from([0x00, 0x82, 0x00, 0x03])),
+    ).toThrow(SyntaxError);
+    expect(() =>
+      utils.parseKey(Buffer.from([0x00, 0x03, 0x00, 0xff])),
+    ).toThrow(SyntaxError);
+  });
   test('Buffer.compare sorts byte by byte', () => {
     const arr = [
       Buffer.from([0x01]),